@@ -2,26 +2,119 @@
 #define ALGOS_H
 
 #include "graph.h"
+#include "heaps.h"
+#include "workspace.h"
+#include "counters.h"
 #include <chrono>
+#include <functional>
+#include <memory>
 
 using namespace std;
 
+// filled in by PerfCountedSolver (perf.h), -1 = not measured / not available
+struct HardwareCounters {
+    ll cycles = -1;
+    ll instructions = -1;
+    ll llc_misses = -1;         // last level cache read misses
+    ll dtlb_misses = -1;        // data TLB read misses
+    ll branch_misses = -1;
+    double task_clock_ms = -1;  // CPU time over all threads, compare with time_ms
+
+    bool any() const {
+        return cycles >= 0 || instructions >= 0 || llc_misses >= 0 || dtlb_misses >= 0 ||
+               branch_misses >= 0 || task_clock_ms >= 0;
+    }
+};
+
 struct Result {
     vector<Weight> distances;
     double time_ms;
     string algorithm_name;
     string implementation_type;
+    double reorder_ms = 0;  // one-off relabelling cost, not in time_ms (see reorder.h)
+    HardwareCounters hw{};
+    WorkCounters work{};    // only filled in builds with SSSP_WORK_COUNTERS (counters.h)
+    int rounds = -1;        // passes made by the round-based solvers (Bellman-Ford), -1 for the rest
+    ll edges_touched = -1;  // out-edges those passes relaxed out of
+    vector<int> parents{};  // shortest-path tree: predecessor of v, -1 for the source and for
+                            // unreached / -INF vertices. Empty unless setTrackParents(true)
+};
+
+// a Result whose distances still live in a SolverWorkspace, valid until the
+// next query on that workspace
+struct ResultView {
+    DistanceView distances;
+    double time_ms;
+    string algorithm_name;
+    string implementation_type;
+    WorkCounters work{};
+
+    Result toResult() const {
+        Result r{distances.copy(), time_ms, algorithm_name, implementation_type};
+        r.work = work;
+        return r;
+    }
 };
 
 // a basic interface for all the algos
 class SSSPSolver {
+protected:
+    bool parentsOn = false;
+
 public:
     virtual ~SSSPSolver() = default;
     virtual Result solve(const Graph& g, int source) = 0;
     virtual string getName() = 0;
     virtual string getType() = 0;
+
+    // have solve() and solveBatch() fill Result::parents as well. Solvers
+    // compile a separate copy of their search for each setting, so with it
+    // off (the default) nothing is recorded or even branched on. Decorators
+    // pass it on to the solver they wrap
+    virtual void setTrackParents(bool on) { parentsOn = on; }
+    bool tracksParents() const { return parentsOn; }
+
+    // threads the last solve really ran with, 0 if that's just the count the
+    // solver was made with. AutoSolver picks its own (a serial engine, or
+    // fewer threads than asked), decorators pass it on
+    virtual int threadsUsed() const { return 0; }
+
+    // one Result per source, in order. The default just loops over solve(),
+    // BFS and the label-correcting solvers override it with batched engines,
+    // which only give distances and step aside while parents are tracked
+    virtual vector<Result> solveBatch(const Graph& g, const vector<int>& sources) {
+        vector<Result> out;
+        out.reserve(sources.size());
+        for (int s : sources) out.push_back(solve(g, s));
+        return out;
+    }
+
+    // solve() into caller-owned memory, for many queries in a row. The
+    // default copies solve()'s answer in; the heap Dijkstras, BFS and SPFA
+    // run inside ws and only reset what the previous query touched.
+    // Distances only, there is no parents array in a workspace
+    virtual ResultView solveInto(const Graph& g, int source, SolverWorkspace& ws) {
+        Result r = solve(g, source);
+        ws.prepare(g.n);
+        for (int v = 0; v < g.n; v++) {
+            if (r.distances[v] != INF) ws.reach(v, r.distances[v]);
+        }
+        return {ws.view(), r.time_ms, r.algorithm_name, r.implementation_type, std::move(r.work)};
+    }
 };
 
+// batched engines (batch.cpp). Sources are processed in groups, groups run
+// on separate threads; each Result's time_ms is its group's time divided by
+// the group size
+//   multiSourceBFS: bit-parallel BFS, 64 sources per machine word
+//   multiSourceLabelCorrecting: SPFA over BATCH_LANES-wide distance vectors,
+//     every edge load relaxes all lanes at once
+const int BATCH_LANES = 16;
+vector<Result> multiSourceBFS(const Graph& g, const vector<int>& sources, int threads,
+                              const string& name, const string& type);
+vector<Result> multiSourceLabelCorrecting(const Graph& g, const vector<int>& sources, int threads,
+                                          const string& name, const string& type);
+
 ///////////////////////////////////////////////////////
 // CPU serial
 
@@ -37,20 +130,34 @@ public:
     Result solve(const Graph& g, int source) override;
     string getName() override { return "Bellman-Ford"; }
     string getType() override { return "CPU Serial"; }
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override {
+        if (parentsOn) return SSSPSolver::solveBatch(g, sources);
+        return multiSourceLabelCorrecting(g, sources, 1, getName(), getType());
+    }
 };
 
 class BFSSerial : public SSSPSolver {
 public:
     Result solve(const Graph& g, int source) override;
+    ResultView solveInto(const Graph& g, int source, SolverWorkspace& ws) override;
     string getName() override { return "BFS"; }
     string getType() override { return "CPU Serial"; }
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override {
+        if (parentsOn) return SSSPSolver::solveBatch(g, sources);
+        return multiSourceBFS(g, sources, 1, getName(), getType());
+    }
 };
 
 class SPFASerial : public SSSPSolver {
 public:
     Result solve(const Graph& g, int source) override;
+    ResultView solveInto(const Graph& g, int source, SolverWorkspace& ws) override;
     string getName() override { return "SPFA"; }
     string getType() override { return "CPU Serial"; }
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override {
+        if (parentsOn) return SSSPSolver::solveBatch(g, sources);
+        return multiSourceLabelCorrecting(g, sources, 1, getName(), getType());
+    }
 };
 
 class LevitSerial : public SSSPSolver {
@@ -60,6 +167,29 @@ public:
     string getType() override { return "CPU Serial"; }
 };
 
+// heap-based Dijkstra, the priority queue is a policy (see heaps.h). The
+// queue is kept between calls (it's empty again after every query), so one
+// instance shouldn't be shared between threads
+template <class Queue>
+class DijkstraHeap : public SSSPSolver {
+private:
+    Queue pq;
+    int pqSize = -1;
+
+    // parent is only written, and only non-null, when Parents is set
+    template <bool Parents>
+    ResultView search(const Graph& g, int source, SolverWorkspace& ws, int* parent);
+public:
+    Result solve(const Graph& g, int source) override;
+    ResultView solveInto(const Graph& g, int source, SolverWorkspace& ws) override;
+    string getName() override { return "Dijkstra (" + Queue::name() + ")"; }
+    string getType() override { return "CPU Serial"; }
+};
+
+using DijkstraQuaternaryHeap = DijkstraHeap<DAryHeap<4>>;
+using DijkstraPairingHeap = DijkstraHeap<PairingHeap>;
+using DijkstraRadixHeap = DijkstraHeap<RadixHeap>;
+
 ///////////////////////////////////////////////////////
 // CPU parallel (using openmp)
 
@@ -81,6 +211,10 @@ public:
     Result solve(const Graph& g, int source) override;
     string getName() override { return "Bellman-Ford"; }
     string getType() override { return "CPU Parallel (OpenMP)"; }
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override {
+        if (parentsOn) return SSSPSolver::solveBatch(g, sources);
+        return multiSourceLabelCorrecting(g, sources, num_threads, getName(), getType());
+    }
 };
 
 class BFSParallel : public SSSPSolver {
@@ -91,6 +225,10 @@ public:
     Result solve(const Graph& g, int source) override;
     string getName() override { return "BFS"; }
     string getType() override { return "CPU Parallel (OpenMP)"; }
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override {
+        if (parentsOn) return SSSPSolver::solveBatch(g, sources);
+        return multiSourceBFS(g, sources, num_threads, getName(), getType());
+    }
 };
 
 class SPFAParallel : public SSSPSolver {
@@ -101,6 +239,10 @@ public:
     Result solve(const Graph& g, int source) override;
     string getName() override { return "SPFA"; }
     string getType() override { return "CPU Parallel (OpenMP)"; }
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override {
+        if (parentsOn) return SSSPSolver::solveBatch(g, sources);
+        return multiSourceLabelCorrecting(g, sources, num_threads, getName(), getType());
+    }
 };
 
 class LevitParallel : public SSSPSolver {
@@ -113,6 +255,34 @@ public:
     string getType() override { return "CPU Parallel (OpenMP)"; }
 };
 
+// delta-stepping (Meyer & Sanders), needs non-negative weights.
+// delta = 0 means pick it from the graph's weight range
+class DeltaSteppingParallel : public SSSPSolver {
+private:
+    int num_threads;
+    Weight delta;
+public:
+    DeltaSteppingParallel(int threads = 8, Weight delta = 0) : num_threads(threads), delta(delta) {}
+    Result solve(const Graph& g, int source) override;
+    string getName() override { return "Delta-Stepping"; }
+    string getType() override { return "CPU Parallel (OpenMP)"; }
+
+    static Weight chooseDelta(const Graph& g);
+};
+
+///////////////////////////////////////////////////////
+// registry, for picking solvers by name (solvers.cpp)
+
+struct SolverEntry {
+    string key;     // "dijkstra-radix", "spfa-omp", ...
+    bool parallel;  // make() uses the thread count
+    function<unique_ptr<SSSPSolver>(int threads)> make;
+};
+
+// every CPU solver, serial ones first, in the order the benchmark runs them
+const vector<SolverEntry>& solverRegistry();
+const SolverEntry& findSolver(const string& key);  // throws on an unknown key
+
 ////////////////////////////////////////////////////////////////
 // GPU
 
@@ -0,0 +1,34 @@
+#ifndef APSP_H
+#define APSP_H
+
+#include "graph.h"
+#include <functional>
+
+using namespace std;
+
+// Johnson all-pairs shortest paths, streamed. Potentials h come from one
+// label-correcting pass (every vertex starts at 0, which is the usual extra
+// source with 0-weight edges without building that graph), then each source
+// runs Dijkstra on w + h[u] - h[v] computed on the fly, so the graph is never
+// copied. Sources are spread over threads, each with its own dist/heap
+// workspace, and every finished row goes straight to the consumer instead of
+// an n x n matrix in memory.
+
+// called from worker threads, possibly concurrently. row has g.n entries
+// (INF = unreachable) and is only valid during the call
+using RowConsumer = function<void(int source, const Weight* row)>;
+
+struct APSPStats {
+    double potentials_ms = 0;  // reweighting pass, 0 if there were no negative weights
+    double rows_ms = 0;        // all the Dijkstras + consumer calls
+};
+
+// false if there's a negative cycle (nothing is emitted then)
+bool johnsonAPSP(const Graph& g, const RowConsumer& consume, int threads = 8, APSPStats* stats = nullptr);
+
+// rows written into an mmapped file of g.n * g.n Weights, row-major, no
+// header. Throws on I/O errors, false on a negative cycle (the file is
+// removed then)
+bool johnsonAPSPToFile(const Graph& g, const string& path, int threads = 8, APSPStats* stats = nullptr);
+
+#endif // APSP_H
@@ -0,0 +1,149 @@
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+
+#include "algos.h"
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+
+// Compressed CSR. Each row is one byte-aligned record:
+//
+//   varint  degree
+//   bytes   ceil(degree * width / 8) of bit-packed weights, w - minWeight
+//           in `width` bits each (width 0 for unit or constant weights)
+//   varints targets in ascending order: the first as zigzag(v - u), then
+//           the gaps between neighbours
+//
+// so a row costs about 1-2 bytes per target plus width / 8 per weight,
+// against 8 for the plain Graph. Records are found through a 32-bit offset
+// per vertex from the start of its block of 64 rows, plus one 64-bit base
+// per block. Rows are decoded on the fly by neighbors(u), which hands out
+// the same Edge{to, weight} as Graph::neighbors.
+class CompressedGraph {
+public:
+    int n = 0;
+    ll m = 0;
+
+    // rows are sorted by (target, weight) while encoding, g isn't touched.
+    // Encodes in parallel on all cores
+    static CompressedGraph compress(const Graph& g);
+
+    // LEB128, 7 bits per byte, high bit set on all but the last byte
+    static const uint8_t* readVarint(const uint8_t* p, uint32_t& out) {
+        uint32_t b = *p++;
+        out = b & 0x7f;
+        for (int shift = 7; b & 0x80; shift += 7) {
+            b = *p++;
+            out |= (b & 0x7f) << shift;
+        }
+        return p;
+    }
+
+    struct EdgeIterator {
+        const uint8_t* p;        // next target varint
+        const uint8_t* packed;   // weights of the row
+        int width;
+        uint32_t mask;
+        Weight base;
+        int i;
+        int to;
+
+        // ++ reads one varint past the last target, also covered by the padding
+        Edge operator*() const {
+            ll bit = (ll)i * width;
+            uint64_t word;
+            memcpy(&word, packed + (bit >> 3), sizeof(word));  // the blob has 8 bytes of tail padding
+            return {to, (Weight)((uint32_t)base + (uint32_t)((word >> (bit & 7)) & mask))};
+        }
+        EdgeIterator& operator++() {
+            uint32_t gap;
+            p = readVarint(p, gap);
+            to += (int)gap;
+            i++;
+            return *this;
+        }
+        // only ever compared against end(), which has the row's degree in i
+        bool operator!=(const EdgeIterator& o) const { return i != o.i; }
+    };
+
+    struct EdgeRange {
+        EdgeIterator first;
+        int degree;
+
+        EdgeIterator begin() const { return first; }
+        EdgeIterator end() const { return {nullptr, nullptr, 0, 0, 0, degree, 0}; }
+        int size() const { return degree; }
+    };
+
+    EdgeRange neighbors(int u) const {
+        uint32_t deg;
+        const uint8_t* p = readVarint(record(u), deg);
+        const uint8_t* packed = p;
+        p += ((ll)deg * width + 7) >> 3;
+        int to = 0;
+        if (deg > 0) {
+            uint32_t zz;
+            p = readVarint(p, zz);
+            to = u + (int)((zz >> 1) ^ -(int32_t)(zz & 1));
+        }
+        return {{p, packed, width, mask, minWeight, 0, to}, (int)deg};
+    }
+
+    int degree(int u) const {
+        uint32_t deg;
+        readVarint(record(u), deg);
+        return (int)deg;
+    }
+
+    int weightBits() const { return width; }
+    ll bytes() const {
+        return (ll)(blob.size() + rowOffset.size() * sizeof(uint32_t) + blockBase.size() * sizeof(ll));
+    }
+    // what the same graph takes as a plain CSR
+    static ll csrBytes(const Graph& g) { return (g.n + 1) * (ll)sizeof(ll) + g.m * (ll)(sizeof(int) + sizeof(Weight)); }
+
+private:
+    static const int BLOCK_SHIFT = 6;
+    vector<ll> blockBase;        // blob offset of row u << BLOCK_SHIFT
+    vector<uint32_t> rowOffset;  // record of u from its block's base
+    vector<uint8_t> blob;
+
+    const uint8_t* record(int u) const { return blob.data() + blockBase[u >> BLOCK_SHIFT] + rowOffset[u]; }
+
+    Weight minWeight = 0;
+    int width = 0;
+    uint32_t mask = 0;
+};
+
+// Dijkstra (4-ary heap), BFS or Bellman-Ford run straight off a
+// CompressedGraph, through the same loops as the plain serial solvers
+// (serial_search.h). The first solve compresses the Graph it's given and keeps
+// the copy until it's handed a different graph; that one-off cost is logged
+// as an [INFO] line on log (nullptr for quiet), not counted in time_ms.
+class CompressedSolver : public SSSPSolver {
+public:
+    enum class Kind { Dijkstra, BFS, BellmanFord };
+
+private:
+    Kind kind;
+    ostream* log;
+    Graph::Identity compressedFrom;  // the graph cg was built from
+    CompressedGraph cg;
+    SolverWorkspace ws;
+    DAryHeap<4> pq;
+    int pqSize = -1;
+
+    const CompressedGraph& compressedFor(const Graph& g);
+    template <bool Parents>
+    Result search(const CompressedGraph& c, int source);
+
+public:
+    CompressedSolver(Kind kind, ostream* log = &cerr) : kind(kind), log(log) {}
+
+    Result solve(const Graph& g, int source) override;
+    string getName() override;
+    string getType() override { return "CPU Serial [varint CSR]"; }
+};
+
+#endif // COMPRESSED_H
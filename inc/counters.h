@@ -0,0 +1,97 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include "graph.h"
+#include <algorithm>
+
+using namespace std;
+
+// Algorithm-level work counters, for comparing how much work SPFA, Levit,
+// delta-stepping and Bellman-Ford do on a graph and not just how long.
+//
+// Only compiled in with -DSSSP_WORK_COUNTERS (make COUNTERS=1). Without it
+// WorkTally is an empty struct whose methods are inline no-ops and
+// WORK_REDUCTION expands to nothing, so the instrumented loops compile to the
+// same code as before. With it the counting happens inside the timed region,
+// so times from the two builds aren't comparable.
+
+struct WorkCounters {
+    ll edges_scanned = 0;  // out-edges looked at
+    ll relaxations = 0;    // edges that lowered a distance
+    ll requeues = 0;       // pushes beyond the first per reached vertex
+    ll pushes = 0;         // queue / heap / bucket inserts, decrease-key counts as one
+    ll pops = 0;           // queue / heap / bucket removals, stale entries included
+    vector<ll> frontier;   // vertices processed per round (BF pass, BFS level,
+                           // SPFA generation, delta-stepping phase)
+};
+
+#ifdef SSSP_WORK_COUNTERS
+
+const bool WORK_COUNTERS_ENABLED = true;
+
+// per-thread accumulator, folded into a WorkCounters once the solve is done
+struct WorkTally {
+    ll edges = 0, relaxed = 0, pushed = 0, popped = 0;
+    ll visited = 0;  // vertices processed, for the parallel solvers' frontier sizes
+
+    void scan(ll k = 1) { edges += k; }
+    void relax(ll k = 1) { relaxed += k; }
+    void push(ll k = 1) { pushed += k; }
+    void pop(ll k = 1) { popped += k; }
+    void visit(ll k = 1) { visited += k; }
+    ll visits() const { return visited; }
+
+    WorkTally& operator+=(const WorkTally& o) {
+        edges += o.edges;
+        relaxed += o.relaxed;
+        pushed += o.pushed;
+        popped += o.popped;
+        visited += o.visited;
+        return *this;
+    }
+
+    void addTo(WorkCounters& w) const {
+        w.edges_scanned += edges;
+        w.relaxations += relaxed;
+        w.pushes += pushed;
+        w.pops += popped;
+    }
+};
+
+#ifdef _OPENMP
+#pragma omp declare reduction(+ : WorkTally : omp_out += omp_in)
+#endif
+// goes on the omp pragma of a loop that counts into t
+#define WORK_REDUCTION(t) reduction(+ : t)
+
+inline void recordFrontier(WorkCounters& w, ll size) { w.frontier.push_back(size); }
+
+// every reached vertex was pushed once for free (the source included), the
+// rest are re-queues. Call after addTo, only for the queue based solvers
+inline void countRequeues(WorkCounters& w, const Weight* dist, int n) {
+    w.requeues = w.pushes - count_if(dist, dist + n, [](Weight d) { return d != INF; });
+}
+
+#else
+
+const bool WORK_COUNTERS_ENABLED = false;
+
+struct WorkTally {
+    void scan(ll = 1) {}
+    void relax(ll = 1) {}
+    void push(ll = 1) {}
+    void pop(ll = 1) {}
+    void visit(ll = 1) {}
+    ll visits() const { return 0; }
+    WorkTally& operator+=(const WorkTally&) { return *this; }
+    void addTo(WorkCounters&) const {}
+};
+
+#define WORK_REDUCTION(t)
+
+inline void recordFrontier(WorkCounters&, ll) {}
+inline void countRequeues(WorkCounters&, const Weight*, int) {}
+
+#endif // SSSP_WORK_COUNTERS
+
+#endif // COUNTERS_H
@@ -2,131 +2,189 @@
 #define GRAPH_H
 
 #include <vector>
+#include <string>
 #include <tuple>
+#include <algorithm>
+#include <stdexcept>
 #include <limits>
-#include <fstream>
-#include <sstream>
 #include <cstring>
 #include <cmath>
+#include <memory>
+#include "weights.h"
 
 using namespace std;
 
 typedef long long ll;
+// weight and distance type of Graph and the solvers in algos.h; other weight
+// types go through BasicGraph<W> and the typed engines in typed.h
 typedef int Weight;
-const Weight INF = numeric_limits<Weight>::max() / 2;
+const Weight INF = DistTraits<Weight>::INF;
+// reachable from a negative cycle, no shortest path (NegativeCycleSolver)
+const Weight NEG_INF = -INF;
 
-// adj list
-struct Edge {
+// what neighbors(u) hands out, one out-edge
+template <typename W>
+struct BasicEdge {
     int to;
-    Weight weight;
+    W weight;
 };
 
-struct Graph {
+// Immutable CSR graph. Out-edges of u live in [rowPtr[u], rowPtr[u+1]) of
+// colIdx/weights (structure of arrays), offsets are 64-bit so m can go past
+// 2^31. Build it with fromEdges(), or load one with loadGraph() from
+// graph_io.h (text edge list or mmapped binary CSR). The arrays are shared
+// between copies, nothing ever writes to them
+template <typename W>
+struct BasicGraph {
+    typedef W WeightType;
+    typedef BasicEdge<W> Edge;
+
     int n;  // num verts
     ll m;   // num edges
-    vector<vector<Edge>> adj;
 
-    // Graph() : n(0), m(0) {}
+    BasicGraph() : BasicGraph(0, vector<ll>(1, 0), {}, {}) {}
+
+    BasicGraph(int vertices, vector<ll> rowPtr, vector<int> colIdx, vector<W> weights)
+        : n(vertices), m((ll)colIdx.size()) {
+        auto owned = make_shared<OwnedArrays>();
+        owned->rowPtr = std::move(rowPtr);
+        owned->colIdx = std::move(colIdx);
+        owned->weights = std::move(weights);
+        this->rowPtr = owned->rowPtr.data();
+        this->colIdx = owned->colIdx.data();
+        this->weights = owned->weights.data();
+        storage = std::move(owned);
+    }
+
+    // wrap arrays that live somewhere else (an mmap), owner keeps them alive
+    BasicGraph(int vertices, ll edges, const ll* rowPtr, const int* colIdx, const W* weights,
+               shared_ptr<const void> owner)
+        : n(vertices), m(edges), storage(std::move(owner)),
+          rowPtr(rowPtr), colIdx(colIdx), weights(weights) {}
 
-    Graph(int vertices) : n(vertices), m(0), adj(vertices) {}
+    struct EdgeIterator {
+        const int* to;
+        const W* w;
+        ll i;
 
-    void addEdge(int from, int to, Weight weight) {
-        adj[from].push_back({to, weight});
-        m++;
+        Edge operator*() const { return {to[i], w[i]}; }
+        EdgeIterator& operator++() { i++; return *this; }
+        bool operator!=(const EdgeIterator& o) const { return i != o.i; }
+    };
+
+    struct EdgeRange {
+        const int* to;
+        const W* w;
+        ll first, last;
+
+        EdgeIterator begin() const { return {to, w, first}; }
+        EdgeIterator end() const { return {to, w, last}; }
+        ll size() const { return last - first; }
+    };
+
+    EdgeRange neighbors(int u) const {
+        return {colIdx, weights, rowPtr[u], rowPtr[u + 1]};
     }
 
-    // load graph (u v w format)
-    static Graph loadFromFile(const string& filename) {
-        ifstream file(filename);
-        if (!file.is_open()) {
-            throw runtime_error("[ERR] Cannot open file: " + filename);
-        }
+    ll degree(int u) const { return rowPtr[u + 1] - rowPtr[u]; }
 
-        int maxVertex = -1;
-        vector<tuple<int, int, Weight>> edges;
-        
-        string line;
-        while (getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            istringstream iss(line);
-            int u, v;
-            Weight w;
-            if (iss >> u >> v >> w) {
-                edges.emplace_back(u, v, w);
-                maxVertex = max(maxVertex, max(u, v));
-            }
+    // what a cache keyed on a graph holds (CompressedSolver, AutoSolver).
+    // Addresses alone don't do: a freed graph's arrays go to the next one
+    // allocated. The weak_ptr pins the storage's control block, which can't
+    // be reused while it's held, and keeps no arrays alive
+    struct Identity {
+        weak_ptr<const void> owner;
+        const ll* rows = nullptr;
+    };
+    Identity identity() const { return {storage, rowPtr}; }
+    bool is(const Identity& id) const {
+        return id.rows == rowPtr && !id.owner.expired() && !id.owner.owner_before(storage) &&
+               !storage.owner_before(id.owner);
+    }
+
+    // raw arrays for hot loops: edges of u are [offsets()[u], offsets()[u+1])
+    const ll* offsets() const { return rowPtr; }
+    const int* targets() const { return colIdx; }
+    const W* edgeWeights() const { return weights; }
+
+    // counting sort of (u, v, w) by source, keeps input order within a row
+    static BasicGraph fromEdges(int vertices, const vector<tuple<int, int, W>>& edges) {
+        vector<ll> ptr(vertices + 1, 0);
+        for (const auto& [u, v, w] : edges) ptr[u + 1]++;
+        for (int u = 0; u < vertices; u++) ptr[u + 1] += ptr[u];
+
+        vector<int> col(edges.size());
+        vector<W> val(edges.size());
+        vector<ll> cursor(ptr.begin(), ptr.end() - 1);
+        for (const auto& [u, v, w] : edges) {
+            ll idx = cursor[u]++;
+            col[idx] = v;
+            val[idx] = w;
         }
-        file.close();
+        return BasicGraph(vertices, std::move(ptr), std::move(col), std::move(val));
+    }
 
-        Graph g(maxVertex + 1);
-        for (auto& [u, v, w] : edges) {
-            g.addEdge(u, v, w);
+    // same vertices, every edge reversed (in-edges become out-edges)
+    BasicGraph transpose() const {
+        vector<ll> ptr(n + 1, 0);
+        for (ll e = 0; e < m; e++) ptr[colIdx[e] + 1]++;
+        for (int v = 0; v < n; v++) ptr[v + 1] += ptr[v];
+
+        vector<int> col(m);
+        vector<W> val(m);
+        vector<ll> cursor(ptr.begin(), ptr.end() - 1);
+        for (int u = 0; u < n; u++) {
+            for (ll e = rowPtr[u]; e < rowPtr[u + 1]; e++) {
+                ll idx = cursor[colIdx[e]]++;
+                col[idx] = u;
+                val[idx] = weights[e];
+            }
         }
-        return g;
+        return BasicGraph(n, std::move(ptr), std::move(col), std::move(val));
     }
 
-    Graph Graph::expandForBFS() const {
-        Graph expanded(n);
-        expanded.adj.assign(n, {});  // start with original size
-        expanded.m = 0;
+    // integer weights only
+    BasicGraph expandForBFS() const {
+        vector<tuple<int, int, W>> edges;
+        edges.reserve(m);
 
         int next = n;
 
         for (int u = 0; u < n; ++u) {
-            for (auto &e : adj[u]) {
+            for (auto e : neighbors(u)) {
                 int v = e.to;
                 int w = e.weight;
                 if (w == 1) {
-                    expanded.addEdge(u, v, 1);
+                    edges.emplace_back(u, v, 1);
                 } else {
                     int cur = u;
                     for (int i = 0; i < w - 1; ++i) {
                         int dummy = next++;
-                        if ((int)expanded.adj.size() <= dummy)
-                            expanded.adj.push_back({});
-                        expanded.addEdge(cur, dummy, 1);
+                        edges.emplace_back(cur, dummy, 1);
                         cur = dummy;
                     }
-                    expanded.addEdge(cur, v, 1);
+                    edges.emplace_back(cur, v, 1);
                 }
             }
         }
 
-        expanded.n = next;
-        return expanded;
+        return fromEdges(next, edges);
     }
 
-
-    // apparently Compressed Sparse Row format is better for GPU
-    struct CSRFormat {
-        vector<int> rowPtr;
+private:
+    struct OwnedArrays {
+        vector<ll> rowPtr;
         vector<int> colIdx;
-        vector<Weight> values;
-        int n, nnz;
-
-        CSRFormat(const Graph& g) : n(g.n), nnz(g.m) {
-            rowPtr.resize(n + 1, 0);
-            colIdx.resize(nnz);
-            values.resize(nnz);
-
-            for (int u = 0; u < n; u++) {
-                rowPtr[u + 1] = rowPtr[u] + g.adj[u].size();
-            }
-
-            int idx = 0;
-            for (int u = 0; u < n; u++) {
-                for (const auto& edge : g.adj[u]) {
-                    colIdx[idx] = edge.to;
-                    values[idx] = edge.weight;
-                    idx++;
-                }
-            }
-        }
+        vector<W> weights;
     };
 
-    CSRFormat toCSR() const {
-        return CSRFormat(*this);
-    }
+    shared_ptr<const void> storage;
+    const ll* rowPtr;
+    const int* colIdx;
+    const W* weights;
 };
 
-#endif // GRAPH_H
\ No newline at end of file
+typedef BasicGraph<Weight> Graph;
+typedef BasicEdge<Weight> Edge;
+
+#endif // GRAPH_H
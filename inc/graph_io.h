@@ -0,0 +1,416 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include "graph.h"
+#include "parallel.h"
+#include <cstdint>
+#include <type_traits>
+#include <charconv>
+#include <fstream>
+#include <omp.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Binary CSR file, version 1. Little endian, every section 8-byte aligned:
+//
+//   BinaryGraphHeader              64 bytes
+//   rowPtr   int64  x (n + 1)
+//   colIdx   int32  x m            (padded to 8 bytes)
+//   weights  weightType x m        (padded to 8 bytes)
+//
+// checksum is FNV-1a over the three sections exactly as they sit in the file.
+// Loading mmaps the file and points the Graph straight at the sections, so
+// nothing gets parsed or copied. One parallel pass checks that rowPtr runs
+// from 0 to m without going down and that every colIdx is below n, so a
+// corrupt file can't send the solvers out of bounds; that's still far less
+// than parsing. Checking the checksum hashes every byte serially, so only
+// loadGraphBinary(path, true) does it.
+
+const char GRAPH_MAGIC[8] = {'S', 'S', 'S', 'P', 'C', 'S', 'R', '\0'};
+const uint32_t GRAPH_FORMAT_VERSION = 1;
+
+enum WeightType : uint32_t {
+    WEIGHT_INT32 = 1,
+    WEIGHT_INT64 = 2,
+    WEIGHT_FLOAT32 = 3,
+    WEIGHT_FLOAT64 = 4,
+    WEIGHT_UINT16 = 5,
+};
+
+template <typename T>
+constexpr uint32_t weightTypeOf() {
+    if (is_same<T, int32_t>::value) return WEIGHT_INT32;
+    if (is_same<T, int64_t>::value) return WEIGHT_INT64;
+    if (is_same<T, float>::value) return WEIGHT_FLOAT32;
+    if (is_same<T, double>::value) return WEIGHT_FLOAT64;
+    if (is_same<T, uint16_t>::value) return WEIGHT_UINT16;
+    return 0;
+}
+
+struct BinaryGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t weightType;
+    uint64_t n;
+    uint64_t m;
+    uint64_t checksum;
+    uint64_t rowPtrOffset;   // byte offsets from the start of the file
+    uint64_t colIdxOffset;
+    uint64_t weightsOffset;
+};
+static_assert(sizeof(BinaryGraphHeader) == 64, "header must stay 64 bytes");
+
+inline uint64_t alignTo8(uint64_t x) { return (x + 7) & ~7ULL; }
+
+// FNV-1a, 64 bit. Chainable: pass the previous result as h
+inline uint64_t fnv1a(const void* data, size_t len, uint64_t h = 1469598103934665603ULL) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+inline string weightTypeName(uint32_t type) {
+    switch (type) {
+    case WEIGHT_INT32: return "int32";
+    case WEIGHT_INT64: return "int64";
+    case WEIGHT_FLOAT32: return "float";
+    case WEIGHT_FLOAT64: return "double";
+    case WEIGHT_UINT16: return "uint16";
+    }
+    return "unknown (" + to_string(type) + ")";
+}
+
+// section offsets for a graph of this size
+template <typename W = Weight>
+inline BinaryGraphHeader makeGraphHeader(uint64_t n, uint64_t m) {
+    BinaryGraphHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC));
+    h.version = GRAPH_FORMAT_VERSION;
+    h.weightType = weightTypeOf<W>();
+    h.n = n;
+    h.m = m;
+    h.rowPtrOffset = sizeof(BinaryGraphHeader);
+    h.colIdxOffset = h.rowPtrOffset + (n + 1) * sizeof(ll);
+    h.weightsOffset = alignTo8(h.colIdxOffset + m * sizeof(int));
+    return h;
+}
+
+inline bool isBinaryGraphFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[8] = {0};
+    file.read(magic, sizeof(magic));
+    return file.gcount() == (streamsize)sizeof(magic) && memcmp(magic, GRAPH_MAGIC, sizeof(magic)) == 0;
+}
+
+// weight type of a binary graph file, 0 if it isn't one
+inline uint32_t graphFileWeightType(const string& filename) {
+    ifstream file(filename, ios::binary);
+    BinaryGraphHeader h;
+    file.read((char*)&h, sizeof(h));
+    if (file.gcount() != (streamsize)sizeof(h) || memcmp(h.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) != 0) return 0;
+    return h.weightType;
+}
+
+template <typename W>
+inline void saveGraphBinary(const BasicGraph<W>& g, const string& filename) {
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("[ERR] Cannot open file: " + filename);
+    }
+
+    BinaryGraphHeader h = makeGraphHeader<W>(g.n, g.m);
+    const char zeros[8] = {0};
+    size_t rowBytes = (g.n + 1) * sizeof(ll);
+    size_t colBytes = g.m * sizeof(int);
+    size_t wBytes = g.m * sizeof(W);
+    size_t colPad = h.weightsOffset - h.colIdxOffset - colBytes;
+    size_t wPad = alignTo8(wBytes) - wBytes;
+
+    uint64_t sum = fnv1a(g.offsets(), rowBytes);
+    sum = fnv1a(g.targets(), colBytes, sum);
+    sum = fnv1a(zeros, colPad, sum);
+    sum = fnv1a(g.edgeWeights(), wBytes, sum);
+    sum = fnv1a(zeros, wPad, sum);
+    h.checksum = sum;
+
+    file.write((const char*)&h, sizeof(h));
+    file.write((const char*)g.offsets(), rowBytes);
+    file.write((const char*)g.targets(), colBytes);
+    file.write(zeros, colPad);
+    file.write((const char*)g.edgeWeights(), wBytes);
+    file.write(zeros, wPad);
+    if (!file) {
+        throw runtime_error("[ERR] Failed writing: " + filename);
+    }
+}
+
+// owns one read-only mapping of a whole file, a Graph can hold it through
+// shared_ptr. Empty files map to nothing (bytes() == nullptr)
+struct MappedFile {
+    void* addr = MAP_FAILED;
+    size_t length = 0;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    explicit MappedFile(const string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("[ERR] Cannot open file: " + filename);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw runtime_error("[ERR] Cannot stat file: " + filename);
+        }
+        length = (size_t)st.st_size;
+        if (length > 0) {
+            addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (length > 0 && addr == MAP_FAILED) {
+            throw runtime_error("[ERR] mmap failed: " + filename);
+        }
+    }
+
+    ~MappedFile() {
+        if (addr != MAP_FAILED) munmap(addr, length);
+    }
+
+    const char* bytes() const { return addr == MAP_FAILED ? nullptr : (const char*)addr; }
+};
+
+template <typename W = Weight>
+inline BasicGraph<W> loadGraphBinary(const string& filename, bool verifyChecksum = false) {
+    auto mapped = make_shared<MappedFile>(filename);
+    const char* base = mapped->bytes();
+    if (mapped->length < sizeof(BinaryGraphHeader)) {
+        throw runtime_error("[ERR] Not a binary graph file: " + filename);
+    }
+
+    BinaryGraphHeader h;
+    memcpy(&h, base, sizeof(h));
+    if (memcmp(h.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) != 0) {
+        throw runtime_error("[ERR] Not a binary graph file: " + filename);
+    }
+    if (h.version != GRAPH_FORMAT_VERSION) {
+        throw runtime_error("[ERR] Unsupported graph format version " + to_string(h.version) + ": " + filename);
+    }
+    if (h.weightType != weightTypeOf<W>()) {
+        throw runtime_error("[ERR] " + filename + " has " + weightTypeName(h.weightType) + " weights, expected " +
+                            weightTypeName(weightTypeOf<W>()) + " (typed_sssp takes any weight type)");
+    }
+    if (h.n > (uint64_t)numeric_limits<int>::max()) {
+        throw runtime_error("[ERR] Too many vertices: " + filename);
+    }
+
+    // before any m * size below can wrap
+    if (h.m > mapped->length / sizeof(int) || h.m > mapped->length / sizeof(W)) {
+        throw runtime_error("[ERR] Truncated or corrupt graph file: " + filename);
+    }
+
+    BinaryGraphHeader expect = makeGraphHeader<W>(h.n, h.m);
+    uint64_t end = alignTo8(expect.weightsOffset + h.m * sizeof(W));
+    if (h.rowPtrOffset != expect.rowPtrOffset || h.colIdxOffset != expect.colIdxOffset ||
+        h.weightsOffset != expect.weightsOffset || end > mapped->length) {
+        throw runtime_error("[ERR] Truncated or corrupt graph file: " + filename);
+    }
+
+    if (verifyChecksum) {
+        uint64_t sum = fnv1a(base + h.rowPtrOffset, end - h.rowPtrOffset);
+        if (sum != h.checksum) {
+            throw runtime_error("[ERR] Checksum mismatch: " + filename);
+        }
+    }
+
+    const ll* rowPtr = (const ll*)(base + h.rowPtrOffset);
+    const int* colIdx = (const int*)(base + h.colIdxOffset);
+    const W* weights = (const W*)(base + h.weightsOffset);
+    const ll n = (ll)h.n, m = (ll)h.m;
+
+    bool bad = rowPtr[0] != 0 || rowPtr[n] != m;
+    #pragma omp parallel for schedule(static) reduction(||:bad)
+    for (ll u = 0; u < n; u++) bad = bad || rowPtr[u] > rowPtr[u + 1];
+    if (bad) {
+        throw runtime_error("[ERR] Corrupt row offsets in graph file: " + filename);
+    }
+    #pragma omp parallel for schedule(static) reduction(||:bad)
+    for (ll e = 0; e < m; e++) bad = bad || (unsigned)colIdx[e] >= (unsigned)n;
+    if (bad) {
+        throw runtime_error("[ERR] Edge target out of range in graph file: " + filename);
+    }
+
+    return BasicGraph<W>((int)h.n, (ll)h.m, rowPtr, colIdx, weights, std::move(mapped));
+}
+
+// Text edge list: one "u v w" per line, '#' starts a comment line, and a
+// first data line with just two numbers is the "n m" header gen_graph
+// writes (n is honoured, so trailing isolated vertices survive).
+//
+// The file is mmapped and cut into one newline-aligned chunk per thread,
+// each thread parses its chunk with from_chars into its own edge list. Then
+// degrees are counted with atomic adds, offsets come from a parallel prefix
+// sum and edges are scattered into place. Scatter order depends on timing so
+// every row is sorted by (target, weight) at the end to keep the CSR
+// deterministic.
+
+// skip blanks, then parse one integer. false if there's no number here
+template <typename T>
+inline bool parseField(const char*& p, const char* end, T& out) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    auto res = from_chars(p, end, out);
+    if (res.ec != errc()) return false;
+    p = res.ptr;
+    return true;
+}
+
+template <typename W = Weight>
+inline BasicGraph<W> loadGraphText(const string& filename) {
+    MappedFile file(filename);
+    const char* data = file.bytes();
+    const size_t len = file.length;
+
+    int nthreads = omp_get_max_threads();
+    vector<vector<int>> srcs(nthreads), dsts(nthreads);
+    vector<vector<W>> ws(nthreads);
+    vector<int> localMax(nthreads, -1);
+    // per chunk: whether it has a data line, and the "n m" header value if
+    // its first data line is one. The header is the file's first data line,
+    // which can sit in any chunk when the ones before hold only comments
+    vector<char> hasData(nthreads, 0);
+    vector<ll> chunkHeader(nthreads, -1);
+    vector<ll> blockSum(nthreads + 1, 0);  // teamExclusiveScan scratch
+    ll headerN = 0;
+
+    vector<ll> rowPtr;
+    vector<int> colIdx;
+    vector<W> weights;
+    int n = 0;
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        const int tid = omp_get_thread_num();
+        const int team = omp_get_num_threads();
+
+        // chunk [lo, hi): every line belongs to the chunk it starts in
+        auto lineStart = [&](size_t pos) {
+            if (pos == 0 || pos >= len) return min(pos, len);
+            const char* nl = (const char*)memchr(data + pos - 1, '\n', len - pos + 1);
+            return nl ? (size_t)(nl - data) + 1 : len;
+        };
+        size_t lo = lineStart(len * tid / team);
+        size_t hi = lineStart(len * (tid + 1) / team);
+
+        auto& src = srcs[tid];
+        auto& dst = dsts[tid];
+        auto& wt = ws[tid];
+        int maxV = -1;
+        bool firstLine = true;
+
+        const char* p = data + lo;
+        const char* end = data + hi;
+        while (p < end) {
+            const char* eol = (const char*)memchr(p, '\n', end - p);
+            if (!eol) eol = end;
+
+            if (p < eol && *p != '#') {
+                const char* q = p;
+                long long a, b;
+                W w;
+                if (parseField(q, eol, a) && parseField(q, eol, b)) {
+                    if (parseField(q, eol, w)) {
+                        if (a >= 0 && b >= 0 && a <= numeric_limits<int>::max() &&
+                            b <= numeric_limits<int>::max()) {
+                            src.push_back((int)a);
+                            dst.push_back((int)b);
+                            wt.push_back(w);
+                            maxV = max(maxV, (int)max(a, b));
+                        }
+                    } else if (firstLine && a >= 0 && a <= numeric_limits<int>::max()) {
+                        chunkHeader[tid] = a;
+                    }
+                }
+                if (firstLine) hasData[tid] = 1;
+                firstLine = false;
+            }
+            p = eol + 1;
+        }
+        localMax[tid] = maxV;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            int maxVertex = *max_element(localMax.begin(), localMax.begin() + team);
+            for (int t = 0; t < team; t++) {
+                if (!hasData[t]) continue;
+                headerN = max<ll>(chunkHeader[t], 0);
+                break;
+            }
+            n = (int)max<ll>(headerN, (ll)maxVertex + 1);
+            rowPtr.assign((size_t)n + 1, 0);
+        }
+
+        // degrees, counted straight from the thread's own edges
+        for (int u : src) __atomic_fetch_add(&rowPtr[u], 1, __ATOMIC_RELAXED);
+
+        // offsets, scanned by this team: parallelExclusiveScan here would
+        // open a nested region and run on one thread
+        #pragma omp barrier
+        ll m = teamExclusiveScan(rowPtr, blockSum);
+        #pragma omp single
+        {
+            colIdx.resize(m);
+            weights.resize(m);
+        }
+
+        // rowPtr doubles as the scatter cursor, afterwards rowPtr[u] is the
+        // end of row u (= start of row u+1), fixed up below
+        for (size_t i = 0; i < src.size(); i++) {
+            ll idx = __atomic_fetch_add(&rowPtr[src[i]], 1, __ATOMIC_RELAXED);
+            colIdx[idx] = dst[i];
+            weights[idx] = wt[i];
+        }
+        vector<int>().swap(src);
+        vector<int>().swap(dst);
+        vector<W>().swap(wt);
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int u = n; u > 0; u--) rowPtr[u] = rowPtr[u - 1];
+            rowPtr[0] = 0;
+        }
+
+        vector<pair<int, W>> row;
+        #pragma omp for schedule(dynamic, 1024)
+        for (int u = 0; u < n; u++) {
+            ll b = rowPtr[u], e = rowPtr[u + 1];
+            if (e - b < 2) continue;
+            row.clear();
+            for (ll i = b; i < e; i++) row.push_back({colIdx[i], weights[i]});
+            sort(row.begin(), row.end());
+            for (ll i = b; i < e; i++) {
+                colIdx[i] = row[i - b].first;
+                weights[i] = row[i - b].second;
+            }
+        }
+    }
+
+    return BasicGraph<W>(n, std::move(rowPtr), std::move(colIdx), std::move(weights));
+}
+
+// binary or text, whichever the file is
+inline Graph loadGraph(const string& filename) {
+    if (isBinaryGraphFile(filename)) return loadGraphBinary(filename);
+    return loadGraphText(filename);
+}
+
+#endif // GRAPH_IO_H
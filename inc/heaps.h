@@ -0,0 +1,257 @@
+#ifndef HEAPS_H
+#define HEAPS_H
+
+#include "graph.h"
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+using namespace std;
+
+// Priority queues for DijkstraHeap<Queue>. They all share the same interface:
+//   reset(n)        - empty the queue, vertex ids are in [0, n)
+//   empty()
+//   push(v, key)    - insert v, or lower its key if it's already queued
+//   pop()           - remove and return the (key, vertex) with the smallest key
+//   clear()         - empty it for the same n, in O(queued) rather than O(n)
+// Indexed heaps do a real decrease-key, the radix heap just pushes a duplicate
+// so callers should skip entries whose key is bigger than dist[v].
+
+// d-ary heap with a position index for decrease-key. d = 4 keeps the tree
+// shallow and a node's children on one cache line. Key is any ordered type
+// (the typed engines in typed.h use int64 and double)
+template <int D, typename Key = Weight>
+class DAryHeap {
+private:
+    vector<pair<Key, int>> heap;
+    vector<int> pos;  // slot of v in heap, -1 if not queued
+
+    void place(int i, pair<Key, int> item) {
+        heap[i] = item;
+        pos[item.second] = i;
+    }
+
+    void siftUp(int i) {
+        auto item = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (heap[parent].first <= item.first) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, item);
+    }
+
+    void siftDown(int i) {
+        auto item = heap[i];
+        int size = (int)heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= size) break;
+            int best = first;
+            int last = min(first + D, size);
+            for (int c = first + 1; c < last; c++) {
+                if (heap[c].first < heap[best].first) best = c;
+            }
+            if (item.first <= heap[best].first) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, item);
+    }
+
+public:
+    static string name() { return to_string(D) + "-ary heap"; }
+
+    void reset(int n) {
+        heap.clear();
+        pos.assign(n, -1);
+    }
+
+    bool empty() const { return heap.empty(); }
+
+    void push(int v, Key key) {
+        if (pos[v] == -1) {
+            heap.push_back({key, v});
+            pos[v] = (int)heap.size() - 1;
+            siftUp(pos[v]);
+        } else if (key < heap[pos[v]].first) {
+            heap[pos[v]].first = key;
+            siftUp(pos[v]);
+        }
+    }
+
+    // smallest key, queue must not be empty
+    Key topKey() const { return heap[0].first; }
+
+    void clear() {
+        for (const auto& item : heap) pos[item.second] = -1;
+        heap.clear();
+    }
+
+    pair<Key, int> pop() {
+        auto top = heap[0];
+        pos[top.second] = -1;
+        auto last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            place(0, last);
+            siftDown(0);
+        }
+        return top;
+    }
+};
+
+// pairing heap, one node per vertex. decrease-key cuts the node out and
+// melds it back with the root, pop does the usual two-pass merge
+class PairingHeap {
+private:
+    vector<Weight> key;
+    vector<int> child, sibling;
+    vector<int> prev;  // parent if leftmost child, else left sibling
+    vector<char> queued;
+    vector<int> pairs;  // scratch for pop
+    int root = -1;
+
+    int meld(int a, int b) {
+        if (a == -1) return b;
+        if (b == -1) return a;
+        if (key[b] < key[a]) swap(a, b);
+        // b becomes the leftmost child of a
+        sibling[b] = child[a];
+        if (child[a] != -1) prev[child[a]] = b;
+        prev[b] = a;
+        child[a] = b;
+        return a;
+    }
+
+    void detach(int v) {
+        if (child[prev[v]] == v) child[prev[v]] = sibling[v];
+        else sibling[prev[v]] = sibling[v];
+        if (sibling[v] != -1) prev[sibling[v]] = prev[v];
+        sibling[v] = prev[v] = -1;
+    }
+
+public:
+    static string name() { return "pairing heap"; }
+
+    void reset(int n) {
+        key.assign(n, INF);
+        child.assign(n, -1);
+        sibling.assign(n, -1);
+        prev.assign(n, -1);
+        queued.assign(n, 0);
+        root = -1;
+    }
+
+    bool empty() const { return root == -1; }
+
+    void clear() {
+        pairs.clear();
+        if (root != -1) pairs.push_back(root);
+        while (!pairs.empty()) {
+            int v = pairs.back();
+            pairs.pop_back();
+            for (int c = child[v]; c != -1; c = sibling[c]) pairs.push_back(c);
+            queued[v] = 0;
+        }
+        root = -1;
+    }
+
+    void push(int v, Weight k) {
+        if (!queued[v]) {
+            queued[v] = 1;
+            key[v] = k;
+            child[v] = sibling[v] = prev[v] = -1;
+            root = meld(root, v);
+        } else if (k < key[v]) {
+            key[v] = k;
+            if (v != root) {
+                detach(v);
+                root = meld(root, v);
+            }
+        }
+    }
+
+    pair<Weight, int> pop() {
+        int top = root;
+        queued[top] = 0;
+
+        // pass 1: meld children pairwise left to right
+        pairs.clear();
+        int c = child[top];
+        while (c != -1) {
+            int a = c;
+            int b = sibling[a];
+            c = b != -1 ? sibling[b] : -1;
+            sibling[a] = prev[a] = -1;
+            if (b != -1) sibling[b] = prev[b] = -1;
+            pairs.push_back(meld(a, b));
+        }
+
+        // pass 2: meld the results right to left
+        root = -1;
+        for (int i = (int)pairs.size() - 1; i >= 0; i--) {
+            root = meld(pairs[i], root);
+        }
+        child[top] = -1;
+        return {key[top], top};
+    }
+};
+
+// monotone radix heap (Ahuja et al.), integer keys only. Bucket i holds keys
+// whose highest bit differing from the last popped key is bit i-1, so each
+// entry moves down at most 32 times. Keys pushed must be >= the last pop
+class RadixHeap {
+private:
+    static_assert(is_integral<Weight>::value, "RadixHeap needs an integer Weight");
+    static const int BUCKETS = 33;
+
+    vector<pair<uint32_t, int>> buckets[BUCKETS];
+    uint32_t last = 0;
+    size_t count = 0;
+
+    static int bucketOf(uint32_t k, uint32_t last) {
+        return k == last ? 0 : 32 - __builtin_clz(k ^ last);
+    }
+
+public:
+    static string name() { return "radix heap"; }
+
+    void reset(int) {
+        for (auto& b : buckets) b.clear();
+        last = 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+
+    void clear() { reset(0); }
+
+    void push(int v, Weight key) {
+        buckets[bucketOf((uint32_t)key, last)].push_back({(uint32_t)key, v});
+        count++;
+    }
+
+    pair<Weight, int> pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) i++;
+            uint32_t new_last = buckets[i][0].first;
+            for (const auto& item : buckets[i]) new_last = min(new_last, item.first);
+            last = new_last;
+            for (const auto& item : buckets[i]) {
+                buckets[bucketOf(item.first, last)].push_back(item);
+            }
+            buckets[i].clear();
+        }
+        auto item = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return {(Weight)item.first, item.second};
+    }
+};
+
+#endif // HEAPS_H
@@ -0,0 +1,92 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "graph.h"
+#include "heaps.h"
+
+using namespace std;
+
+// Graph whose edges can be inserted, deleted and re-weighted, plus an SSSP
+// tree kept up to date across batches of such changes. Weights must stay
+// non-negative.
+
+// one change. INSERT of an existing edge and SET of a missing one both act
+// as "make u -> v weigh w"; DELETE of a missing edge is a no-op
+struct EdgeUpdate {
+    enum Kind { INSERT, DELETE, SET };
+    Kind kind;
+    int u, v;
+    Weight w;  // ignored for DELETE
+};
+
+// out- and in-adjacency as per-vertex vectors. Parallel edges of the input
+// are merged into one with the smallest weight, which leaves distances alone
+class DynamicGraph {
+public:
+    int n = 0;
+
+    DynamicGraph() = default;
+    explicit DynamicGraph(const Graph& g);
+
+    // the old weight of u -> v, INF if the edge wasn't there. Throws on a
+    // negative weight or a vertex out of range
+    Weight set(int u, int v, Weight w);
+    Weight remove(int u, int v);
+    Weight weight(int u, int v) const;  // INF if there's no such edge
+
+    const vector<Edge>& outEdges(int u) const { return out[u]; }
+    const vector<Edge>& inEdges(int v) const { return in[v]; }  // Edge::to is the tail here
+    ll edges() const { return m; }
+
+    // immutable CSR snapshot, for running the ordinary solvers on it
+    Graph toGraph() const;
+
+private:
+    ll m = 0;
+    vector<vector<Edge>> out, in;
+};
+
+// what one applied batch cost
+struct UpdateStats {
+    int updates = 0;
+    int invalidated = 0;  // vertices whose tree path used an edge that got heavier or went away
+    int settled = 0;      // vertices popped by the repair Dijkstra
+    ll scanned = 0;       // edges looked at
+    double time_ms = 0;
+};
+
+// Distances and a shortest-path tree from one source, repaired after every
+// batch instead of recomputed:
+//   - edges that got heavier or were deleted and carried a tree edge
+//     invalidate the subtree hanging below them (Ramalingam & Reps). Those
+//     vertices get a tentative distance from their in-edges out of the rest
+//     of the tree
+//   - edges that got lighter or were inserted seed their head if it improves
+//   - one Dijkstra from all seeds then settles only vertices whose distance
+//     actually changes
+// so a batch costs roughly the size of the changed region plus its edges,
+// not O(m log n).
+class IncrementalSSSP {
+public:
+    IncrementalSSSP(const Graph& g, int source);
+
+    UpdateStats apply(const vector<EdgeUpdate>& batch);
+
+    int source() const { return src; }
+    const DynamicGraph& graph() const { return dg; }
+    const vector<Weight>& distances() const { return dist; }
+    const vector<int>& parents() const { return parent; }  // -1 for the source and unreached vertices
+
+private:
+    DynamicGraph dg;
+    int src;
+    vector<Weight> dist;
+    vector<int> parent;
+    DAryHeap<4> pq;
+    vector<char> invalid;  // all 0 between batches
+    vector<int> stack;
+
+    void settle(UpdateStats& stats);
+};
+
+#endif // INCREMENTAL_H
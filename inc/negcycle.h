@@ -0,0 +1,42 @@
+#ifndef NEGCYCLE_H
+#define NEGCYCLE_H
+
+#include "algos.h"
+#include <iostream>
+
+using namespace std;
+
+// SSSP with negative weights and negative cycles. Distances of vertices a
+// negative cycle can reach come back as NEG_INF, everything else is exact.
+//
+// Label-correcting FIFO Bellman-Ford with Tarjan's subtree disassembly: the
+// shortest-path tree is kept as a preorder thread, and when an edge u -> v
+// lowers dist[v] the whole subtree of v is cut loose before v is re-hung
+// under u. Finding u inside that subtree means the parent graph just closed
+// a cycle, which is negative, so cycles are caught the moment they form
+// instead of after n-1 rounds. The disassembled vertices also stop being
+// scanned with labels that are about to drop anyway.
+//
+// Each cycle found is kept and everything it reaches is marked NEG_INF with a
+// parallel frontier BFS. Those vertices leave the tree and the queue, and the
+// search carries on until the remaining labels settle.
+class NegativeCycleSolver : public SSSPSolver {
+private:
+    int num_threads;
+    ostream* log;
+    vector<vector<int>> found;  // cycles of the last solve
+    vector<int> logged;         // last cycle reported on log, to keep reps quiet
+
+public:
+    NegativeCycleSolver(int threads = 8, ostream* log = &cerr) : num_threads(threads), log(log) {}
+
+    Result solve(const Graph& g, int source) override;
+    string getName() override { return "Bellman-Ford (Tarjan)"; }
+    string getType() override { return "CPU Parallel (OpenMP)"; }
+
+    // negative cycles the last solve ran into, each as v0 -> v1 -> ... -> v0
+    // with the closing edge implied. Empty if there were none
+    const vector<vector<int>>& cycles() const { return found; }
+};
+
+#endif // NEGCYCLE_H
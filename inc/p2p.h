@@ -0,0 +1,99 @@
+#ifndef P2P_H
+#define P2P_H
+
+#include "graph.h"
+#include "heaps.h"
+#include <memory>
+#include <cstdint>
+
+using namespace std;
+
+// Point-to-point (s -> t) queries. All of these stop as soon as t's distance
+// is known instead of finishing the whole SSSP tree, and need non-negative
+// weights.
+//
+// ALT (Goldberg & Harrelson): distances to and from K landmarks give, via the
+// triangle inequality, a lower bound on d(v, t) that A* uses as heuristic.
+// The tables cost 2*K*n Weights and are built once per graph, then saved next
+// to it (graph file + ".lmk") and reloaded by later runs.
+
+// landmark file, little endian:
+//   LandmarkFileHeader   40 bytes
+//   landmark ids  int32  x k
+//   from          Weight x n*k   from[v*k + i] = d(landmark i, v)
+//   to            Weight x n*k   to[v*k + i]   = d(v, landmark i)
+const char LANDMARK_MAGIC[8] = {'S', 'S', 'S', 'P', 'L', 'M', 'K', '\0'};
+const uint32_t LANDMARK_FORMAT_VERSION = 1;
+
+struct LandmarkFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t k;
+    uint64_t n;
+    uint64_t m;
+    uint64_t graphChecksum;  // FNV-1a of the CSR arrays, catches a stale file
+};
+static_assert(sizeof(LandmarkFileHeader) == 40, "header must stay 40 bytes");
+
+struct LandmarkTable {
+    int n = 0;
+    int k = 0;
+    vector<int> landmarks;
+    vector<Weight> from;  // vertex-major so one lowerBound() reads two short runs
+    vector<Weight> to;
+    double time_ms = 0;   // building or loading
+
+    // farthest-point selection: each new landmark is the vertex farthest
+    // (d(L,v) + d(v,L)) from all the ones picked so far, starting from the
+    // vertex farthest from `seed`. rev is g.transpose()
+    static LandmarkTable build(const Graph& g, const Graph& rev, int k, int seed = 0);
+
+    void save(const string& filename, const Graph& g) const;
+    // throws if the file is missing, corrupt or was built for another graph
+    static LandmarkTable load(const string& filename, const Graph& g);
+
+    // lower bound on d(v, t), INF if the tables prove t unreachable from v
+    Weight lowerBound(int v, int t) const;
+};
+
+inline string landmarkPath(const string& graphFile) { return graphFile + ".lmk"; }
+
+// load graphFile's landmark table if it exists and has k landmarks, otherwise
+// build and save it (a failed save only prints a warning)
+LandmarkTable loadOrBuildLandmarks(const Graph& g, const Graph& rev, const string& graphFile, int k);
+
+struct QueryResult {
+    Weight distance;      // INF if t can't be reached
+    double time_ms;
+    ll settled;           // vertices popped, over both directions
+    string algorithm_name;
+};
+
+// Per-query state is reset sparsely (only what the last query touched), so
+// back-to-back queries cost what they explore, not O(n). Not thread-safe:
+// copy the engine per thread, copies share the graph arrays and landmarks
+class PointToPointEngine {
+private:
+    Graph g, rev;
+    shared_ptr<const LandmarkTable> landmarks;
+
+    vector<Weight> distF, distB;
+    vector<int> touchedF, touchedB;
+    DAryHeap<4> heapF, heapB;
+
+    void resetState();
+
+public:
+    // rev must be g.transpose(), pass it in when it's already around
+    PointToPointEngine(const Graph& g, const Graph& rev, shared_ptr<const LandmarkTable> landmarks = nullptr);
+    explicit PointToPointEngine(const Graph& g) : PointToPointEngine(g, g.transpose()) {}
+
+    void setLandmarks(shared_ptr<const LandmarkTable> table);
+    bool hasLandmarks() const { return landmarks != nullptr; }
+
+    QueryResult dijkstra(int s, int t);       // one direction, stops when t is popped
+    QueryResult bidirectional(int s, int t);  // stops once topF + topB >= best s-t path
+    QueryResult altAStar(int s, int t);       // needs landmarks
+};
+
+#endif // P2P_H
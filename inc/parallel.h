@@ -0,0 +1,103 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <omp.h>
+
+using namespace std;
+
+// In-place exclusive prefix sum run by the team that calls it, from inside
+// a parallel region (every thread of the team has to call it). Each thread
+// scans its own block, block totals get scanned serially (one per thread),
+// then each thread adds its block's offset. blockSum is shared scratch with
+// room for team + 1 entries. a is complete on return, and every thread gets
+// the grand total
+template <typename T>
+T teamExclusiveScan(vector<T>& a, vector<T>& blockSum) {
+    size_t len = a.size();
+    int tid = omp_get_thread_num();
+    int team = omp_get_num_threads();
+    size_t lo = len * tid / team, hi = len * (tid + 1) / team;
+
+    T sum = 0;
+    for (size_t i = lo; i < hi; i++) {
+        T x = a[i];
+        a[i] = sum;
+        sum += x;
+    }
+    blockSum[tid + 1] = sum;
+
+    #pragma omp barrier
+    #pragma omp single
+    {
+        blockSum[0] = 0;
+        for (int t = 0; t < team; t++) blockSum[t + 1] += blockSum[t];
+    }
+
+    T offset = blockSum[tid];
+    for (size_t i = lo; i < hi; i++) a[i] += offset;
+
+    #pragma omp barrier
+    return blockSum[team];
+}
+
+// the same scan in a parallel region of its own. Returns the grand total
+template <typename T>
+T parallelExclusiveScan(vector<T>& a) {
+    int nthreads = omp_get_max_threads();
+    vector<T> blockSum(nthreads + 1, 0);
+    T total = 0;
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        T mine = teamExclusiveScan(a, blockSum);
+        if (omp_get_thread_num() == 0) total = mine;
+    }
+
+    return total;
+}
+
+// LSD radix sort of 64-bit keys on their low `bits` bits, 8 bits a pass.
+// Each thread counts digits in its own block, one serial scan over
+// (digit, thread) hands every thread its output slots, then the blocks
+// scatter independently. Stable, so the result doesn't depend on the
+// thread count
+inline void parallelRadixSort(vector<uint64_t>& keys, int bits = 64) {
+    size_t len = keys.size();
+    vector<uint64_t> tmp(len);
+    int nthreads = omp_get_max_threads();
+    vector<size_t> counts((size_t)nthreads * 256);
+
+    for (int shift = 0; shift < bits; shift += 8) {
+        #pragma omp parallel num_threads(nthreads)
+        {
+            int tid = omp_get_thread_num();
+            int team = omp_get_num_threads();
+            size_t lo = len * tid / team, hi = len * (tid + 1) / team;
+            size_t* mine = &counts[(size_t)tid * 256];
+
+            fill(mine, mine + 256, 0);
+            for (size_t i = lo; i < hi; i++) mine[(keys[i] >> shift) & 255]++;
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                size_t running = 0;
+                for (int d = 0; d < 256; d++) {
+                    for (int t = 0; t < team; t++) {
+                        size_t c = counts[(size_t)t * 256 + d];
+                        counts[(size_t)t * 256 + d] = running;
+                        running += c;
+                    }
+                }
+            }
+
+            for (size_t i = lo; i < hi; i++) tmp[mine[(keys[i] >> shift) & 255]++] = keys[i];
+        }
+        keys.swap(tmp);
+    }
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,39 @@
+#ifndef PATHS_H
+#define PATHS_H
+
+#include "graph.h"
+#include <string>
+
+using namespace std;
+
+// Paths out of a shortest-path tree, i.e. Result::parents from a solver that
+// had setTrackParents(true).
+
+// many source -> target paths stored back to back, CSR style: path i is
+// vertices[offsets[i], offsets[i+1]), source first and target last. Empty
+// for a target the tree doesn't reach
+struct PathSet {
+    vector<ll> offsets;
+    vector<int> vertices;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    bool reached(size_t i) const { return offsets[i + 1] > offsets[i]; }
+    ll hops(size_t i) const { return reached(i) ? offsets[i + 1] - offsets[i] - 1 : -1; }
+    const int* begin(size_t i) const { return vertices.data() + offsets[i]; }
+    const int* end(size_t i) const { return vertices.data() + offsets[i + 1]; }
+    vector<int> path(size_t i) const { return vector<int>(begin(i), end(i)); }
+};
+
+// every target's path in one go. Tree depths are memoised, so a stretch
+// that several paths share is climbed once to size them all; then one
+// allocation holds every path and threads fill them in from the target end.
+// Throws if parents isn't a tree (a cycle or an id out of range)
+PathSet extractPaths(const vector<int>& parents, int source, const vector<int>& targets, int threads = 8);
+
+// checks parents against the distances it came with: -1 on the source and on
+// INF / -INF vertices, and for every other v an edge parent[v] -> v with
+// dist[parent] + w == dist[v], all the way back to the source without a
+// cycle. Returns what's wrong, empty if it's a valid shortest-path tree
+string validateParents(const Graph& g, int source, const vector<Weight>& dist, const vector<int>& parents);
+
+#endif // PATHS_H
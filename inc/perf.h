@@ -0,0 +1,65 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include "algos.h"
+#include <memory>
+
+using namespace std;
+
+// Hardware counters around solve() via Linux perf_event_open.
+//
+// Counting is per thread: start() opens every event on every thread the
+// process has at that moment (OpenMP pool threads included) and stop() sums
+// them. Threads spawned during the call aren't counted, which only matters
+// on the first run of a new thread count, so warm-ups take care of it.
+// Events the kernel refuses (no PMU in a VM, perf_event_paranoid, unknown
+// event) just stay at -1, nothing here throws.
+
+class PerfSession {
+public:
+    PerfSession() = default;
+    ~PerfSession() { closeAll(); }
+    PerfSession(const PerfSession&) = delete;
+    PerfSession& operator=(const PerfSession&) = delete;
+
+    void start();
+    HardwareCounters stop();
+
+    // events that opened on the last start(), "none" plus the reason if nothing did
+    string describe() const;
+
+private:
+    struct OpenEvent {
+        int event;  // index into the event table in perf.cpp
+        int fd;
+    };
+    vector<OpenEvent> events;
+    unsigned opened = 0;   // bit per event that opened on at least one thread
+    unsigned refused = 0;  // events the kernel said no to, not retried
+    int lastErrno = 0;
+
+    void closeAll();
+};
+
+// decorator like ReorderedSolver: fills Result::hw for the inner solver's
+// calls. solveBatch spreads the totals evenly over the results, as with time
+class PerfCountedSolver : public SSSPSolver {
+private:
+    shared_ptr<PerfSession> session;
+    unique_ptr<SSSPSolver> inner;
+public:
+    PerfCountedSolver(shared_ptr<PerfSession> session, unique_ptr<SSSPSolver> inner)
+        : session(std::move(session)), inner(std::move(inner)) {}
+
+    Result solve(const Graph& g, int source) override;
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override;
+    void setTrackParents(bool on) override {
+        SSSPSolver::setTrackParents(on);
+        inner->setTrackParents(on);
+    }
+    int threadsUsed() const override { return inner->threadsUsed(); }
+    string getName() override { return inner->getName(); }
+    string getType() override { return inner->getType(); }
+};
+
+#endif // PERF_H
@@ -0,0 +1,73 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "algos.h"
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+// One quick parallel pass over the graph: weight range and sign, degree
+// skew, plus a double-sweep BFS for the hop diameter. Enough to tell which
+// solver is correct on the graph and roughly which one is fastest.
+struct GraphProfile {
+    int n = 0;
+    ll m = 0;
+    Weight minWeight = 0, maxWeight = 0;
+    bool unitWeights = false;      // every weight is 1, BFS gives exact distances
+    bool negativeWeights = false;  // rules out Dijkstra, BFS and delta-stepping
+    double avgDegree = 0;
+    ll maxDegree = 0;
+    int diameter = 0;   // hop eccentricity estimate, a lower bound on directed graphs
+    double time_ms = 0;
+
+    static GraphProfile of(const Graph& g, int threads);
+
+    double degreeSkew() const { return avgDegree > 0 ? maxDegree / avgDegree : 0; }
+    string describe() const;
+};
+
+// what AutoSolver runs and why
+struct AutoDecision {
+    string key;    // solver registry key
+    int threads;   // 1 for serial engines
+    string reason;
+};
+
+// the dispatch rules, apart from AutoSolver so they can be looked at on their own
+AutoDecision chooseSolver(const GraphProfile& p, int threads);
+
+// Meta-solver: profiles the graph on first use, picks an engine from the
+// registry with chooseSolver() and forwards every call to it. The profile is
+// redone when it's handed a different graph. Decisions get logged as [INFO]
+// lines on log (nullptr for quiet)
+class AutoSolver : public SSSPSolver {
+private:
+    int num_threads;
+    ostream* log;
+    Graph::Identity profiled;  // the graph the engine was picked for
+    GraphProfile profile;
+    AutoDecision decision;
+    unique_ptr<SSSPSolver> engine;
+
+    SSSPSolver& engineFor(const Graph& g);
+
+public:
+    AutoSolver(int threads = 8, ostream* log = &cerr) : num_threads(threads), log(log) {}
+
+    Result solve(const Graph& g, int source) override;
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override;
+    ResultView solveInto(const Graph& g, int source, SolverWorkspace& ws) override;
+    void setTrackParents(bool on) override {
+        SSSPSolver::setTrackParents(on);
+        if (engine) engine->setTrackParents(on);
+    }
+    int threadsUsed() const override { return engine ? decision.threads : 0; }
+    string getName() override { return engine ? "Auto (" + decision.key + ")" : "Auto"; }
+    string getType() override { return engine ? engine->getType() : "CPU Auto"; }
+
+    const GraphProfile& lastProfile() const { return profile; }
+    const AutoDecision& lastDecision() const { return decision; }
+};
+
+#endif // PROFILE_H
@@ -0,0 +1,141 @@
+#ifndef RELAX_H
+#define RELAX_H
+
+#include "graph.h"
+#include <vector>
+#include <cstdint>
+
+// Lock-free relaxation primitives shared by the parallel solvers. They work on
+// plain vector<Weight>/vector<int> storage (Result hands dist back as a normal
+// vector) through the gcc/clang __atomic builtins. Relaxed ordering is enough
+// here, the omp barriers between rounds give us the happens-before we need.
+// Solvers without those barriers ask for __ATOMIC_SEQ_CST through Order
+// where they need it (see releaseClaim).
+
+// read a slot that other threads may be writing
+template <int Order = __ATOMIC_RELAXED, typename T>
+inline T atomicLoad(const T* slot) {
+    return __atomic_load_n(slot, Order);
+}
+
+template <typename T>
+inline void atomicStore(T* slot, T value) {
+    __atomic_store_n(slot, value, __ATOMIC_RELAXED);
+}
+
+// fetch-min: lower *slot to value if it's smaller. Returns true if this
+// thread's value was written, i.e. this thread won the relaxation
+template <int Order = __ATOMIC_RELAXED, typename T>
+inline bool atomicMin(T* slot, T value) {
+    T old = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    while (value < old) {
+        if (__atomic_compare_exchange_n(slot, &old, value, true, Order, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// claim a vertex flag (frontier / in-queue / state): flips *flag from
+// expected to desired, returns true for exactly one of the racing threads
+template <int Order = __ATOMIC_RELAXED, typename T>
+inline bool tryClaim(T* flag, T expected = 0, T desired = 1) {
+    return __atomic_compare_exchange_n(flag, &expected, desired, false, Order, Order);
+}
+
+// give a claimed in-queue flag back before reading the distance it guards,
+// for solvers without a barrier between the two. Store then load on one
+// side, store (lower dist) then load (see the flag) on the other: if both
+// missed the other's store, the writer skips the requeue and the owner
+// scans with the old dist, losing the update. Only a seq_cst total order
+// over all four rules that out, so the owner follows this with a seq_cst
+// dist load and writers use the seq_cst relax and tryClaim. x86 emits the
+// same instructions as for relaxed ones (locked RMWs and plain loads), weaker
+// machines get the fences they need
+template <typename T>
+inline void releaseClaim(T* flag, T value = 0) {
+    __atomic_exchange_n(flag, value, __ATOMIC_SEQ_CST);
+}
+
+// Per-vertex labels for the parallel solvers, picked at compile time by
+// whether the shortest-path tree is wanted:
+//   Labels<false>  a plain Weight per vertex, exactly what the solvers used
+//                  before parents existed
+//   Labels<true>   (dist, parent) packed into one 64-bit word, so a
+//                  relaxation moves both with one CAS and nobody can pair a
+//                  distance with the parent of another update
+// relax() and claim() take the parent either way, Labels<false> drops it.
+// peek() and set() are plain accesses, for where the original code had
+// them: no other thread is writing that vertex at the time. load() and
+// relax() take an Order like the primitives above
+template <bool Parents>
+struct Labels;
+
+template <>
+struct Labels<false> {
+    vector<Weight> dist;
+
+    explicit Labels(int n) : dist(n, INF) {}
+
+    Weight peek(int v) const { return dist[v]; }
+    template <int Order = __ATOMIC_RELAXED>
+    Weight load(int v) const { return atomicLoad<Order>(&dist[v]); }
+    void set(int v, Weight d, int) { dist[v] = d; }
+    template <int Order = __ATOMIC_RELAXED>
+    bool relax(int v, Weight d, int) { return atomicMin<Order>(&dist[v], d); }
+    bool claim(int v, Weight expected, Weight d, int) { return tryClaim(&dist[v], expected, d); }
+
+    vector<Weight> takeDistances() { return std::move(dist); }
+    vector<int> takeParents() { return {}; }
+};
+
+template <>
+struct Labels<true> {
+    vector<uint64_t> key;
+
+    // dist in the high half, so equal words mean equal (dist, parent) and
+    // unreached is pack(INF, -1)
+    static uint64_t pack(Weight d, int parent) { return (uint64_t)(uint32_t)d << 32 | (uint32_t)parent; }
+    static Weight distOf(uint64_t k) { return (Weight)(int32_t)(uint32_t)(k >> 32); }
+    static int parentOf(uint64_t k) { return (int)(int32_t)(uint32_t)k; }
+
+    explicit Labels(int n) : key(n, pack(INF, -1)) {}
+
+    Weight peek(int v) const { return distOf(key[v]); }
+    template <int Order = __ATOMIC_RELAXED>
+    Weight load(int v) const { return distOf(atomicLoad<Order>(&key[v])); }
+    void set(int v, Weight d, int parent) { key[v] = pack(d, parent); }
+
+    // atomicMin on the distance half, the parent rides along
+    template <int Order = __ATOMIC_RELAXED>
+    bool relax(int v, Weight d, int parent) {
+        uint64_t old = atomicLoad(&key[v]);
+        uint64_t now = pack(d, parent);
+        while (d < distOf(old)) {
+            if (__atomic_compare_exchange_n(&key[v], &old, now, true, Order, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // only from an unreached vertex (BFS), which has no parent yet
+    bool claim(int v, Weight expected, Weight d, int parent) {
+        return tryClaim(&key[v], pack(expected, -1), pack(d, parent));
+    }
+
+    vector<Weight> takeDistances() const {
+        vector<Weight> dist(key.size());
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < key.size(); v++) dist[v] = distOf(key[v]);
+        return dist;
+    }
+    vector<int> takeParents() const {
+        vector<int> parent(key.size());
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < key.size(); v++) parent[v] = parentOf(key[v]);
+        return parent;
+    }
+};
+
+#endif // RELAX_H
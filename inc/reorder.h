@@ -0,0 +1,65 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "algos.h"
+#include <memory>
+
+using namespace std;
+
+// Vertex relabelling to give the solvers some locality on dist[]. A
+// Reordering holds the permuted graph plus both directions of the mapping,
+// ReorderedSolver runs any solver on it and hands distances back in the
+// original ids.
+
+enum class Ordering {
+    None,
+    DegreeDescending,  // high out-degree first
+    RCM,               // reverse Cuthill-McKee
+    BFS,               // BFS discovery order from the root
+    DFS,               // DFS preorder from the root
+    HubCluster,        // above-average degree vertices first, order kept otherwise
+};
+
+Ordering parseOrdering(const string& name);  // "none", "degree", "rcm", "bfs", "dfs", "hub"
+string orderingName(Ordering kind);
+
+struct Reordering {
+    Ordering kind = Ordering::None;
+    Graph graph;          // permuted copy
+    vector<int> newId;    // original id -> permuted id
+    vector<int> oldId;    // permuted id -> original id
+    double time_ms = 0;   // computing the order + building the permuted graph
+
+    // root seeds BFS/DFS/RCM (other components follow in id order)
+    static Reordering compute(const Graph& g, Ordering kind, int root = 0);
+
+    vector<Weight> toOriginal(const vector<Weight>& dist) const;
+    vector<int> parentsToOriginal(const vector<int>& parent) const;  // both index and value mapped
+};
+
+// relabel g so vertex v becomes newId[v]. Rows get sorted by target
+Graph permuteGraph(const Graph& g, const vector<int>& newId, const vector<int>& oldId);
+
+class ReorderedSolver : public SSSPSolver {
+private:
+    shared_ptr<const Reordering> order;
+    unique_ptr<SSSPSolver> inner;
+public:
+    ReorderedSolver(shared_ptr<const Reordering> order, unique_ptr<SSSPSolver> inner)
+        : order(std::move(order)), inner(std::move(inner)) {}
+
+    // g is the original graph `order` was computed from, the inner solver
+    // runs on order->graph. time_ms is the inner solve only, the one-off
+    // reorder cost goes in reorder_ms
+    Result solve(const Graph& g, int source) override;
+    vector<Result> solveBatch(const Graph& g, const vector<int>& sources) override;
+    void setTrackParents(bool on) override {
+        SSSPSolver::setTrackParents(on);
+        inner->setTrackParents(on);
+    }
+    int threadsUsed() const override { return inner->threadsUsed(); }
+    string getName() override { return inner->getName(); }
+    string getType() override { return inner->getType() + " [" + orderingName(order->kind) + "]"; }
+};
+
+#endif // REORDER_H
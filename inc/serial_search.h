@@ -0,0 +1,167 @@
+#ifndef SERIAL_SEARCH_H
+#define SERIAL_SEARCH_H
+
+#include "algos.h"
+
+using namespace std;
+
+// The serial Dijkstra, BFS and Bellman-Ford loops, templated on the graph:
+// anything with Graph's n, neighbors(u) and degree(u) runs the same code.
+// cpu_serial.cpp runs them on Graph, compressed.cpp on CompressedGraph.
+// parent is only written, and only non-null, when Parents is set; name and
+// type label the result.
+
+// pq / pqSize belong to the caller, kept between queries: pq is reset only
+// when n changes
+template <bool Parents, class G, class Queue>
+ResultView dijkstraSearch(const G& g, int source, SolverWorkspace& ws, Queue& pq, int& pqSize, int* parent,
+                          const string& name, const string& type) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    ws.prepare(g.n);
+    if (pqSize != g.n) {
+        pq.reset(g.n);
+        pqSize = g.n;
+    } else {
+        pq.clear();
+    }
+    Weight* dist = ws.dist;
+    WorkTally tally;
+
+    ws.reach(source, 0);
+    pq.push(source, 0);
+    tally.push();
+
+    while (!pq.empty()) {
+        auto [du, u] = pq.pop();
+        tally.pop();
+        if (du > dist[u]) continue;  // stale duplicate (radix heap)
+
+        for (const auto& edge : g.neighbors(u)) {
+            Weight nd = du + edge.weight;
+            tally.scan();
+            if (nd < dist[edge.to]) {
+                ws.reach(edge.to, nd);
+                if constexpr (Parents) parent[edge.to] = u;
+                pq.push(edge.to, nd);
+                tally.relax();
+                tally.push();
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    WorkCounters work;
+    tally.addTo(work);
+    countRequeues(work, dist, g.n);
+    return {ws.view(), elapsed, name, type, std::move(work)};
+}
+
+template <bool Parents, class G>
+ResultView bfsSearch(const G& g, int source, SolverWorkspace& ws, int* parent, const string& name,
+                     const string& type) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    ws.prepare(g.n);
+    Weight* dist = ws.dist;
+    int* q = ws.queue;  // every vertex goes in once, no wrap-around needed
+    int head = 0, tail = 0;
+    WorkCounters work;
+    WorkTally tally;
+    int levelStart = 0, levelEnd = 1;  // queue slice holding the current level
+
+    ws.reach(source, 0);
+    q[tail++] = source;
+    tally.push();
+
+    while (head < tail) {
+        if (head == levelEnd) {
+            recordFrontier(work, levelEnd - levelStart);
+            levelStart = levelEnd;
+            levelEnd = tail;
+        }
+        int u = q[head++];
+        tally.pop();
+        
+        for (const auto& edge : g.neighbors(u)) {
+            tally.scan();
+            if (dist[edge.to] > dist[u] + 1) {
+                ws.reach(edge.to, dist[u] + 1);
+                if constexpr (Parents) parent[edge.to] = u;
+                q[tail++] = edge.to;
+                tally.relax();
+                tally.push();
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    recordFrontier(work, tail - levelStart);
+    tally.addTo(work);
+    return {ws.view(), elapsed, name, type, std::move(work)};
+}
+
+// frontier-driven: a round only relaxes out of the vertices whose distance
+// dropped in the round before, and the loop ends when none did. Still at most
+// n-1 rounds, which is where classic Bellman-Ford would stop on a negative cycle
+template <bool Parents, class G>
+Result bellmanFordSearch(const G& g, int source, const string& name, const string& type) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<Weight> dist(g.n, INF);
+    std::vector<int> parent(Parents ? g.n : 0, -1);
+    std::vector<int> frontier, next;
+    std::vector<char> queued(g.n, 0);  // already in next
+    WorkCounters work;
+    WorkTally tally;
+    int rounds = 0;
+    ll touched = 0;
+
+    dist[source] = 0;
+    frontier.push_back(source);
+    tally.push();
+
+    while (!frontier.empty() && rounds < g.n - 1) {
+        rounds++;
+        recordFrontier(work, (ll)frontier.size());
+        for (int u : frontier) {
+            Weight du = dist[u];
+            tally.pop();
+            touched += g.degree(u);
+            for (const auto& edge : g.neighbors(u)) {
+                tally.scan();
+                if (du + edge.weight < dist[edge.to]) {
+                    dist[edge.to] = du + edge.weight;
+                    if constexpr (Parents) parent[edge.to] = u;
+                    tally.relax();
+                    if (!queued[edge.to]) {
+                        queued[edge.to] = 1;
+                        next.push_back(edge.to);
+                        tally.push();
+                    }
+                }
+            }
+        }
+        for (int v : next) queued[v] = 0;
+        frontier.swap(next);
+        next.clear();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    tally.addTo(work);
+    countRequeues(work, dist.data(), g.n);
+    Result r{std::move(dist), elapsed, name, type};
+    r.work = std::move(work);
+    r.rounds = rounds;
+    r.edges_touched = touched;
+    r.parents = std::move(parent);
+    return r;
+}
+
+#endif // SERIAL_SEARCH_H
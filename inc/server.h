@@ -0,0 +1,141 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "algos.h"
+#include "p2p.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Long-lived query server: the graph is loaded once and queries arrive over
+// stdin/stdout or a Unix domain socket.
+//
+// Wire format, little endian, every message is one frame:
+//   u32 length            bytes that follow this field
+//   u32 id                chosen by the client, echoed in the response
+//   u8  op / status
+//   ...payload
+//
+// requests (op):
+//   OP_SSSP      i32 source                 -> u32 n, Weight x n
+//   OP_P2P       i32 s, i32 t, u8 method    -> Weight distance, i64 settled
+//   OP_STATS                                -> LatencySummary x 2 (SSSP, P2P)
+//   OP_SHUTDOWN                             -> empty, server drains and exits
+// responses start with STATUS_OK, or STATUS_ERROR followed by a message.
+// A connection may pipeline requests, responses come back in completion
+// order, so match them by id.
+//
+// Requests from every connection go through one queue. Each worker pulls up
+// to maxBatch at a time and hands all the SSSP ones to solveBatch() together,
+// so solvers with batched engines (BFS, SPFA, Bellman-Ford) serve bursts of
+// sources in one pass.
+
+enum ServerOp : uint8_t {
+    OP_SSSP = 1,
+    OP_P2P = 2,
+    OP_STATS = 3,
+    OP_SHUTDOWN = 4,
+};
+
+enum P2PMethod : uint8_t {
+    P2P_DIJKSTRA = 0,
+    P2P_BIDIRECTIONAL = 1,
+    P2P_ALT = 2,
+};
+
+enum ServerStatus : uint8_t {
+    STATUS_OK = 0,
+    STATUS_ERROR = 1,
+};
+
+const uint32_t MAX_FRAME_BYTES = 1 << 20;
+
+// latency = request fully read -> response written, in microseconds, over
+// the last LATENCY_WINDOW queries of that kind
+const size_t LATENCY_WINDOW = 1 << 16;
+
+struct LatencySummary {
+    uint64_t count;
+    double p50, p90, p99, max;
+};
+
+struct ServerConfig {
+    int workers = 8;
+    int maxBatch = 16;
+};
+
+class QueryServer {
+public:
+    using SolverFactory = function<unique_ptr<SSSPSolver>()>;
+
+    // makeSolver is called once per worker. P2P queries need non-negative
+    // weights; without them, or ALT without landmarks, those requests fail
+    QueryServer(const Graph& g, SolverFactory makeSolver, shared_ptr<const LandmarkTable> landmarks,
+                ServerConfig config);
+
+    // both block until OP_SHUTDOWN (or EOF on stdin) and every queued request
+    // has been answered
+    void serveStdio();
+    void serveSocket(const string& path);
+
+    LatencySummary latency(ServerOp op) const;
+    string latencyReport() const;
+
+private:
+    // closed when the reader and every queued request are done with it
+    struct Connection {
+        int inFd, outFd;
+        bool ownsFd;    // socket yes, stdin/stdout no
+        mutex writeMu;  // workers answer concurrently
+
+        Connection(int in, int out, bool owns) : inFd(in), outFd(out), ownsFd(owns) {}
+        ~Connection();
+    };
+
+    struct Request {
+        shared_ptr<Connection> conn;
+        uint32_t id;
+        uint8_t op;
+        vector<char> payload;
+        chrono::steady_clock::time_point received;
+    };
+
+    Graph g, rev;
+    SolverFactory makeSolver;
+    shared_ptr<const LandmarkTable> landmarks;
+    ServerConfig config;
+    bool p2pReady = false;  // weights are non-negative
+
+    mutex queueMu;
+    condition_variable queueCv;
+    deque<Request> queue;
+    bool stopping = false;
+    bool shutdownRequested = false;
+    Request shutdownRequest;  // answered once the queue is drained
+
+    mutex connMu;
+    condition_variable readersCv;
+    vector<weak_ptr<Connection>> connections;
+    int activeReaders = 0;
+    int listenFd = -1;
+
+    mutable mutex latencyMu;
+    vector<double> latencyUs[2];  // SSSP, P2P; ring buffers of LATENCY_WINDOW
+    uint64_t latencyCount[2] = {0, 0};
+
+    void run(const function<void()>& accept);
+    void readLoop(shared_ptr<Connection> conn);
+    void workerLoop();
+    void requestStop();
+    void respond(const Request& req, uint8_t status, const vector<char>& body);
+    void fail(const Request& req, const string& message);
+    void recordLatency(const Request& req);
+};
+
+#endif // SERVER_H
@@ -0,0 +1,40 @@
+#ifndef TYPED_H
+#define TYPED_H
+
+#include "graph_io.h"
+#include <memory>
+
+using namespace std;
+
+// SSSP over graphs of any weight type the binary format knows (int32, int64,
+// float, uint16), for when the int solvers in algos.h don't fit: float
+// latencies, or int sums that wrap 32 bits.
+//
+// The engines are templates on the weight type W, the distance type D and
+// the WeightClass of the graph, so each instantiation only carries the code
+// its graph needs. UnitWeights runs BFS and never loads a weight,
+// NonNegative runs Dijkstra on a 4-ary heap keyed by D, General runs SPFA
+// with a negative cycle check. Nothing inside the loops asks which case it
+// is in; loadTypedEngine() reads the weight type from the file header,
+// classifies the weights once and picks the instantiation.
+class TypedEngine {
+public:
+    virtual ~TypedEngine() = default;
+
+    // distances stay in the engine until the next solve, returns time in ms
+    virtual double solve(int source) = 0;
+
+    virtual int vertices() const = 0;
+    virtual ll edges() const = 0;
+    virtual bool reached(int v) const = 0;
+    virtual string distance(int v) const = 0;  // "INF" when unreached
+    virtual uint64_t distanceHash() const = 0; // fnv1a of the distance array
+    virtual string describe() const = 0;       // weight / distance types, class, algorithm
+};
+
+// narrow picks WeightTraits<W>::Narrow for distances instead of ::Dist.
+// Text files carry no weight type, they're parsed as textWeights
+unique_ptr<TypedEngine> loadTypedEngine(const string& filename, bool narrow = false,
+                                        uint32_t textWeights = WEIGHT_INT32);
+
+#endif // TYPED_H
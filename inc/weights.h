@@ -0,0 +1,90 @@
+#ifndef WEIGHTS_H
+#define WEIGHTS_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+using namespace std;
+
+// Compile-time description of edge weight and distance types.
+//
+// DistTraits<D>::INF is the "unreached" sentinel. For integers it's max / 2,
+// so INF + w never overflows for a weight that fits in half the range and
+// an unreached vertex can't win a relaxation when weights are non-negative.
+// Floats use real infinity, which absorbs any finite weight.
+//
+// WeightTraits<W>::Dist is the default distance type for weight W, wide
+// enough that long paths don't wrap: int32 and uint16 weights sum in 64 bits
+// and float in double. Narrow is the cheaper 32-bit choice for graphs whose
+// distances are known to fit.
+
+template <typename D>
+struct DistTraits {
+    static_assert(is_arithmetic<D>::value, "distances must be arithmetic");
+    static constexpr D INF = is_floating_point<D>::value ? numeric_limits<D>::infinity()
+                                                         : numeric_limits<D>::max() / 2;
+};
+
+template <typename W>
+struct WeightTraits;
+
+template <>
+struct WeightTraits<int32_t> {
+    using Dist = int64_t;
+    using Narrow = int32_t;
+    static const char* name() { return "int32"; }
+};
+
+template <>
+struct WeightTraits<int64_t> {
+    using Dist = int64_t;
+    using Narrow = int64_t;
+    static const char* name() { return "int64"; }
+};
+
+template <>
+struct WeightTraits<float> {
+    using Dist = double;
+    using Narrow = float;
+    static const char* name() { return "float"; }
+};
+
+template <>
+struct WeightTraits<uint16_t> {
+    using Dist = int64_t;
+    using Narrow = int32_t;
+    static const char* name() { return "uint16"; }
+};
+
+// what the solver may assume about every weight in the graph, found once
+// per load by classifyWeights()
+enum class WeightClass {
+    UnitWeights,  // all exactly 1: BFS, no weight loads at all
+    NonNegative,  // Dijkstra is exact, unreached vertices need no INF check
+    General,      // negative weights possible: label-correcting with INF checks
+};
+
+inline string weightClassName(WeightClass c) {
+    switch (c) {
+    case WeightClass::UnitWeights: return "unit weights";
+    case WeightClass::NonNegative: return "non-negative";
+    case WeightClass::General: return "general";
+    }
+    return "?";
+}
+
+template <typename W>
+WeightClass classifyWeights(const W* weights, long long m) {
+    bool unit = m > 0, negative = false;
+    #pragma omp parallel for schedule(static) reduction(&&:unit) reduction(||:negative)
+    for (long long e = 0; e < m; e++) {
+        unit = unit && weights[e] == W(1);
+        if constexpr (is_signed<W>::value) negative = negative || weights[e] < W(0);
+    }
+    if (negative) return WeightClass::General;
+    return unit ? WeightClass::UnitWeights : WeightClass::NonNegative;
+}
+
+#endif // WEIGHTS_H
@@ -0,0 +1,119 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "graph.h"
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+// Scratch memory for running many queries on one graph without allocating.
+// All per-vertex arrays are carved out of one arena block that is only
+// reallocated when n grows. Between queries only the vertices the last query
+// touched get reset, so a query that explores k vertices costs O(k) setup
+// instead of O(n).
+//
+// Contract for solvers: dist[] is INF and flag[] is 0 everywhere except on
+// vertices passed to reach(), and flag may only be set on reached vertices.
+
+// bump allocator over one 64-byte aligned block
+class Arena {
+private:
+    char* block = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() { free(block); }
+
+    // drop everything handed out, make room for at least bytes
+    void reset(size_t bytes) {
+        used = 0;
+        if (bytes <= capacity) return;
+        free(block);
+        capacity = (bytes + 63) & ~(size_t)63;
+        block = (char*)aligned_alloc(64, capacity);
+        if (!block) {
+            capacity = 0;
+            throw bad_alloc();
+        }
+    }
+
+    template <typename T>
+    T* take(size_t count) {
+        size_t bytes = (count * sizeof(T) + 63) & ~(size_t)63;
+        if (used + bytes > capacity) throw runtime_error("[ERR] Arena overflow");
+        T* p = (T*)(block + used);
+        used += bytes;
+        return p;
+    }
+
+    // what reset() needs for these arrays
+    template <typename T>
+    static size_t bytesFor(size_t count) { return (count * sizeof(T) + 63) & ~(size_t)63; }
+};
+
+// read-only distances owned by someone else (usually a workspace). Valid
+// until that owner runs its next query
+struct DistanceView {
+    const Weight* data = nullptr;
+    int n = 0;
+
+    Weight operator[](int v) const { return data[v]; }
+    int size() const { return n; }
+    const Weight* begin() const { return data; }
+    const Weight* end() const { return data + n; }
+    vector<Weight> copy() const { return vector<Weight>(data, data + n); }
+};
+
+class SolverWorkspace {
+private:
+    Arena arena;
+    int sized = -1;     // n the arrays were carved for
+    int* touched = nullptr;
+    int touchedCount = 0;
+
+public:
+    Weight* dist = nullptr;  // INF unless reached
+    char* flag = nullptr;    // in-queue / visited / state, 0 unless reached
+    int* queue = nullptr;    // n + 1 slots, enough for a ring buffer FIFO
+
+    SolverWorkspace() = default;
+    SolverWorkspace(const SolverWorkspace&) = delete;
+    SolverWorkspace& operator=(const SolverWorkspace&) = delete;
+
+    // call at the start of every query
+    void prepare(int n) {
+        if (n != sized) {
+            arena.reset(Arena::bytesFor<Weight>(n) + Arena::bytesFor<char>(n) +
+                        Arena::bytesFor<int>(n) + Arena::bytesFor<int>(n + 1));
+            dist = arena.take<Weight>(n);
+            flag = arena.take<char>(n);
+            touched = arena.take<int>(n);
+            queue = arena.take<int>(n + 1);
+            fill(dist, dist + n, INF);
+            memset(flag, 0, n);
+            sized = n;
+        } else {
+            for (int i = 0; i < touchedCount; i++) {
+                dist[touched[i]] = INF;
+                flag[touched[i]] = 0;
+            }
+        }
+        touchedCount = 0;
+    }
+
+    // set dist[v], remembering v for the next reset the first time it's reached
+    void reach(int v, Weight d) {
+        if (dist[v] == INF) touched[touchedCount++] = v;
+        dist[v] = d;
+    }
+
+    int reached() const { return touchedCount; }
+    DistanceView view() const { return {dist, sized}; }
+};
+
+#endif // WORKSPACE_H
@@ -0,0 +1,109 @@
+#ifndef WORKSTEAL_H
+#define WORKSTEAL_H
+
+#include "graph.h"
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+// Chase-Lev work-stealing deque of vertex ids (Chase & Lev 2005, with the
+// C11 memory orders of Le et al. 2013). The owning thread pushes and takes at
+// the bottom, any other thread steals from the top, and only a take racing a
+// steal for the last element needs a CAS. The ring doubles when it fills up.
+// Old rings stay alive until the deque goes away, a thief may still be
+// reading from one.
+class alignas(64) ChaseLevDeque {
+public:
+    static const int EMPTY = -1;
+
+    explicit ChaseLevDeque(ll capacity = 1024) {
+        ll cap = 1;
+        while (cap < capacity) cap <<= 1;
+        rings.emplace_back(new Ring(cap));
+        ring = rings.back().get();
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // owner only
+    void push(int v) {
+        ll b = __atomic_load_n(&bottom, __ATOMIC_RELAXED);
+        ll t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+        Ring* r = ring;
+        if (b - t > r->mask) r = grow(t, b);
+        r->put(b, v);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+    }
+
+    // owner only, newest first. EMPTY if there's nothing left
+    int take() {
+        ll b = __atomic_load_n(&bottom, __ATOMIC_RELAXED) - 1;
+        Ring* r = ring;
+        __atomic_store_n(&bottom, b, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        ll t = __atomic_load_n(&top, __ATOMIC_RELAXED);
+        if (t > b) {
+            __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+            return EMPTY;
+        }
+        int v = r->get(b);
+        if (t == b) {
+            // last one, a thief may be after it too
+            if (!__atomic_compare_exchange_n(&top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                v = EMPTY;
+            }
+            __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+        }
+        return v;
+    }
+
+    // any thread, oldest first. EMPTY if there was nothing or another thread
+    // got there first
+    int steal() {
+        ll t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        ll b = __atomic_load_n(&bottom, __ATOMIC_ACQUIRE);
+        if (t >= b) return EMPTY;
+        Ring* r = __atomic_load_n(&ring, __ATOMIC_ACQUIRE);
+        int v = r->get(t);
+        if (!__atomic_compare_exchange_n(&top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            return EMPTY;
+        }
+        return v;
+    }
+
+    // a racy snapshot, good enough to pick a victim or decide to spill
+    bool empty() const {
+        return __atomic_load_n(&top, __ATOMIC_RELAXED) >= __atomic_load_n(&bottom, __ATOMIC_RELAXED);
+    }
+
+private:
+    struct Ring {
+        ll mask;
+        vector<int> slot;
+
+        explicit Ring(ll cap) : mask(cap - 1), slot(cap) {}
+        int get(ll i) const { return __atomic_load_n(&slot[i & mask], __ATOMIC_RELAXED); }
+        void put(ll i, int v) { __atomic_store_n(&slot[i & mask], v, __ATOMIC_RELAXED); }
+    };
+
+    // top is written by thieves, bottom only by the owner: separate lines
+    alignas(64) ll top = 0;
+    alignas(64) ll bottom = 0;
+    Ring* ring;
+    vector<unique_ptr<Ring>> rings;  // owner only
+
+    Ring* grow(ll t, ll b) {
+        Ring* old = ring;
+        rings.emplace_back(new Ring(2 * (old->mask + 1)));
+        Ring* r = rings.back().get();
+        for (ll i = t; i < b; i++) r->put(i, old->get(i));
+        __atomic_store_n(&ring, r, __ATOMIC_RELEASE);
+        return r;
+    }
+};
+
+#endif // WORKSTEAL_H
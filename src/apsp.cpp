@@ -0,0 +1,130 @@
+#include "../inc/apsp.h"
+#include "../inc/heaps.h"
+#include <omp.h>
+#include <deque>
+#include <chrono>
+#include <stdexcept>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// SPFA from a virtual source joined to everyone with weight 0: all h start at
+// 0 and all vertices start queued. A vertex queued n times means a negative
+// cycle
+static bool computePotentials(const Graph& g, std::vector<Weight>& h) {
+    h.assign(g.n, 0);
+    std::vector<char> inQueue(g.n, 1);
+    std::vector<int> timesQueued(g.n, 1);
+    std::deque<int> q;
+    for (int v = 0; v < g.n; v++) q.push_back(v);
+
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop_front();
+        inQueue[u] = 0;
+        for (const auto& edge : g.neighbors(u)) {
+            if (h[u] + edge.weight < h[edge.to]) {
+                h[edge.to] = h[u] + edge.weight;
+                if (!inQueue[edge.to]) {
+                    if (++timesQueued[edge.to] > g.n) return false;
+                    inQueue[edge.to] = 1;
+                    q.push_back(edge.to);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool johnsonAPSP(const Graph& g, const RowConsumer& consume, int threads, APSPStats* stats) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bool negative = false;
+    const Weight* w = g.edgeWeights();
+    #pragma omp parallel for reduction(||:negative) num_threads(threads)
+    for (ll e = 0; e < g.m; e++) negative = negative || w[e] < 0;
+
+    std::vector<Weight> h(g.n, 0);
+    if (negative && !computePotentials(g, h)) return false;
+
+    auto mid = std::chrono::high_resolution_clock::now();
+
+    const ll* off = g.offsets();
+    const int* to = g.targets();
+
+    #pragma omp parallel num_threads(threads)
+    {
+        // per-thread workspace, reused for every source this thread gets
+        std::vector<Weight> dist(g.n);
+        DAryHeap<4> pq;
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < g.n; s++) {
+            std::fill(dist.begin(), dist.end(), INF);
+            pq.reset(g.n);
+            dist[s] = 0;
+            pq.push(s, 0);
+
+            while (!pq.empty()) {
+                auto [du, u] = pq.pop();
+                for (ll e = off[u]; e < off[u + 1]; e++) {
+                    int v = to[e];
+                    Weight nd = du + w[e] + h[u] - h[v];  // reduced cost, >= 0
+                    if (nd < dist[v]) {
+                        dist[v] = nd;
+                        pq.push(v, nd);
+                    }
+                }
+            }
+
+            // back to real weights
+            for (int v = 0; v < g.n; v++) {
+                if (dist[v] != INF) dist[v] = dist[v] - h[s] + h[v];
+            }
+            consume(s, dist.data());
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    if (stats) {
+        stats->potentials_ms = negative ? std::chrono::duration<double, std::milli>(mid - start).count() : 0;
+        stats->rows_ms = std::chrono::duration<double, std::milli>(end - mid).count();
+    }
+    return true;
+}
+
+bool johnsonAPSPToFile(const Graph& g, const string& path, int threads, APSPStats* stats) {
+    size_t rowBytes = (size_t)g.n * sizeof(Weight);
+    size_t length = rowBytes * g.n;
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw runtime_error("[ERR] Cannot open file: " + path);
+    if (ftruncate(fd, (off_t)length) != 0) {
+        close(fd);
+        throw runtime_error("[ERR] Cannot size output file: " + path);
+    }
+    if (length == 0) {
+        close(fd);
+        return true;
+    }
+    void* addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) throw runtime_error("[ERR] mmap failed: " + path);
+
+    char* base = (char*)addr;
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    bool ok = johnsonAPSP(g, [&](int s, const Weight* row) {
+        size_t begin = (size_t)s * rowBytes;
+        memcpy(base + begin, row, rowBytes);
+        // start writeback now so dirty pages don't pile up until munmap
+        size_t aligned = begin & ~(page - 1);
+        msync(base + aligned, begin + rowBytes - aligned, MS_ASYNC);
+    }, threads, stats);
+
+    munmap(addr, length);
+    // a negative cycle leaves the file sized but empty, which reads like
+    // a valid all-zero matrix
+    if (!ok) unlink(path.c_str());
+    return ok;
+}
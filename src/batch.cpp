@@ -0,0 +1,155 @@
+#include "../inc/algos.h"
+#include <omp.h>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// MS-BFS (Then et al.): bit k of seen/visit/next belongs to source k, so one
+// scan of u's edges advances up to 64 BFS traversals. dist[k] gets the hop
+// count, same as BFSSerial
+static void msBFSGroup(const Graph& g, const int* src, int count, std::vector<std::vector<Weight>>& dist) {
+    std::vector<uint64_t> seen(g.n, 0), visit(g.n, 0), next(g.n, 0);
+    for (int k = 0; k < count; k++) {
+        dist[k].assign(g.n, INF);
+        dist[k][src[k]] = 0;
+        seen[src[k]] |= 1ULL << k;
+        visit[src[k]] |= 1ULL << k;
+    }
+
+    Weight level = 0;
+    bool active = true;
+    while (active) {
+        for (int u = 0; u < g.n; u++) {
+            if (!visit[u]) continue;
+            for (auto e : g.neighbors(u)) next[e.to] |= visit[u];
+        }
+
+        active = false;
+        for (int v = 0; v < g.n; v++) {
+            uint64_t fresh = next[v] & ~seen[v];
+            next[v] = 0;
+            visit[v] = fresh;
+            if (!fresh) continue;
+            active = true;
+            seen[v] |= fresh;
+            for (; fresh; fresh &= fresh - 1) dist[__builtin_ctzll(fresh)][v] = level + 1;
+        }
+        level++;
+    }
+}
+
+// BATCH_LANES distances in one SIMD register (gcc/clang vector extension,
+// lowers to AVX-512/AVX2/SSE depending on -march)
+typedef Weight LaneVec __attribute__((vector_size(BATCH_LANES * sizeof(Weight))));
+
+// SPFA where every vertex carries BATCH_LANES distances (lane k = source k)
+// stored contiguously, so relaxing an edge is one vector add + min over all
+// lanes. A vertex is queued when any of its lanes improves.
+//
+// A lane with a reachable negative cycle would keep the queue going forever.
+// Like BellmanFordSerial::solve it stops after n-1 generations (a FIFO
+// generation settles at least one more edge of every shortest path, so
+// lanes without a cycle are exact by then) and leaves the cycle lanes where
+// they got to. Labels saturate at NEG_INF on the way down, no overflow
+static void laneSPFAGroup(const Graph& g, const int* src, int count, std::vector<std::vector<Weight>>& dist) {
+    const int K = BATCH_LANES;
+    std::vector<Weight> lanes((size_t)g.n * K, INF);
+    std::vector<char> inQueue(g.n, 0);
+    std::vector<int> queue(g.n + 1);  // ring buffer, a vertex is queued at most once
+    size_t head = 0, tail = 0, cap = queue.size();
+
+    for (int k = 0; k < count; k++) {
+        lanes[(size_t)src[k] * K + k] = 0;
+        if (!inQueue[src[k]]) {
+            inQueue[src[k]] = 1;
+            queue[tail++] = src[k];
+        }
+    }
+
+    const ll* off = g.offsets();
+    const int* to = g.targets();
+    const Weight* wt = g.edgeWeights();
+    LaneVec infVec, negInfVec;
+    for (int k = 0; k < K; k++) {
+        infVec[k] = INF;
+        negInfVec[k] = NEG_INF;
+    }
+    int rounds = 0, genLeft = 0;
+
+    while (head != tail) {
+        if (genLeft == 0) {
+            if (rounds == g.n - 1) break;
+            rounds++;
+            genLeft = (int)((tail + cap - head) % cap);
+        }
+        genLeft--;
+        int u = queue[head];
+        head = head + 1 == cap ? 0 : head + 1;
+        inQueue[u] = 0;
+
+        LaneVec du;
+        memcpy(&du, &lanes[(size_t)u * K], sizeof(du));
+        auto unreached = du >= infVec;
+
+        for (ll e = off[u]; e < off[u + 1]; e++) {
+            int v = to[e];
+            Weight* slot = &lanes[(size_t)v * K];
+            LaneVec dv, nd;
+            memcpy(&dv, slot, sizeof(dv));
+            nd = du + wt[e];
+            nd = nd < negInfVec ? negInfVec : nd;
+            nd = unreached ? infVec : nd;
+            LaneVec best = nd < dv ? nd : dv;
+            if (memcmp(&best, &dv, sizeof(dv)) == 0) continue;
+
+            memcpy(slot, &best, sizeof(best));
+            if (!inQueue[v]) {
+                inQueue[v] = 1;
+                queue[tail] = v;
+                tail = tail + 1 == cap ? 0 : tail + 1;
+            }
+        }
+    }
+
+    for (int k = 0; k < count; k++) {
+        dist[k].resize(g.n);
+        for (int v = 0; v < g.n; v++) dist[k][v] = lanes[(size_t)v * K + k];
+    }
+}
+
+typedef void (*GroupEngine)(const Graph&, const int*, int, std::vector<std::vector<Weight>>&);
+
+static std::vector<Result> runGroups(const Graph& g, const std::vector<int>& sources, int threads,
+                                     int width, GroupEngine engine, const string& name, const string& type) {
+    std::vector<Result> out(sources.size());
+    int groups = (int)((sources.size() + width - 1) / width);
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(std::max(1, threads))
+    for (int grp = 0; grp < groups; grp++) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        size_t first = (size_t)grp * width;
+        int count = (int)std::min<size_t>(width, sources.size() - first);
+        std::vector<std::vector<Weight>> dist(count);
+        engine(g, &sources[first], count, dist);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        for (int k = 0; k < count; k++) {
+            out[first + k] = {std::move(dist[k]), elapsed / count, name, type};
+        }
+    }
+
+    return out;
+}
+
+std::vector<Result> multiSourceBFS(const Graph& g, const std::vector<int>& sources, int threads,
+                                   const string& name, const string& type) {
+    return runGroups(g, sources, threads, 64, msBFSGroup, name, type);
+}
+
+std::vector<Result> multiSourceLabelCorrecting(const Graph& g, const std::vector<int>& sources, int threads,
+                                               const string& name, const string& type) {
+    return runGroups(g, sources, threads, BATCH_LANES, laneSPFAGroup, name, type);
+}
@@ -7,7 +7,8 @@
 
 using namespace std;
 
-inline constexpr int INF = numeric_limits<int>::max();
+// max / 2 like INF in inc/graph.h, so dist[u] + w can't wrap when u is unreached
+inline constexpr int INF = numeric_limits<int>::max() / 2;
 inline constexpr int NEG_INF = -INF;
 
 inline string dist_to_string(int d) {
@@ -0,0 +1,154 @@
+#include "../inc/compressed.h"
+#include "../inc/serial_search.h"
+#include <omp.h>
+#include <algorithm>
+#include <iomanip>
+
+static int varintBytes(uint32_t x) {
+    int k = 1;
+    while (x >= 0x80) {
+        x >>= 7;
+        k++;
+    }
+    return k;
+}
+
+static uint8_t* writeVarint(uint8_t* p, uint32_t x) {
+    while (x >= 0x80) {
+        *p++ = (uint8_t)(x | 0x80);
+        x >>= 7;
+    }
+    *p++ = (uint8_t)x;
+    return p;
+}
+
+static uint32_t zigzag(int d) { return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31); }
+
+// row u sorted by (target, weight), most rows come in sorted already
+static void sortedRow(const Graph& g, int u, std::vector<std::pair<int, Weight>>& row) {
+    row.clear();
+    for (const auto& edge : g.neighbors(u)) row.push_back({edge.to, edge.weight});
+    if (!std::is_sorted(row.begin(), row.end())) std::sort(row.begin(), row.end());
+}
+
+CompressedGraph CompressedGraph::compress(const Graph& g) {
+    CompressedGraph c;
+    c.n = g.n;
+    c.m = g.m;
+    std::vector<ll> rowBytes(g.n + 1, 0);
+
+    const Weight* w = g.edgeWeights();
+
+    Weight lo = g.m ? w[0] : 0, hi = lo;
+    #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
+    for (ll e = 0; e < g.m; e++) {
+        lo = std::min(lo, w[e]);
+        hi = std::max(hi, w[e]);
+    }
+    uint32_t range = (uint32_t)hi - (uint32_t)lo;
+    c.minWeight = lo;
+    c.width = range ? 32 - __builtin_clz(range) : 0;
+    c.mask = c.width == 32 ? ~0u : (1u << c.width) - 1;
+
+    // two passes over sorted rows: sizes, prefix sum, then the bytes
+    #pragma omp parallel
+    {
+        std::vector<std::pair<int, Weight>> row;
+        #pragma omp for schedule(dynamic, 1024)
+        for (int u = 0; u < g.n; u++) {
+            sortedRow(g, u, row);
+            ll deg = (ll)row.size();
+            ll size = varintBytes((uint32_t)deg) + ((deg * c.width + 7) >> 3);
+            int prev = u;
+            for (size_t i = 0; i < row.size(); i++) {
+                size += varintBytes(i == 0 ? zigzag(row[i].first - prev) : (uint32_t)(row[i].first - prev));
+                prev = row[i].first;
+            }
+            rowBytes[u + 1] = size;
+        }
+    }
+
+    for (int u = 0; u < g.n; u++) rowBytes[u + 1] += rowBytes[u];
+    // tail padding for the iterators' 8-byte weight loads and trailing varint read
+    c.blob.assign(rowBytes[g.n] + 8, 0);
+    c.blockBase.resize(((ll)g.n >> BLOCK_SHIFT) + 1);
+    c.rowOffset.resize(g.n);
+    for (int u = 0; u < g.n; u++) {
+        if ((u & ((1 << BLOCK_SHIFT) - 1)) == 0) c.blockBase[u >> BLOCK_SHIFT] = rowBytes[u];
+        ll rel = rowBytes[u] - c.blockBase[u >> BLOCK_SHIFT];
+        if (rel > UINT32_MAX) throw std::runtime_error("[ERR] Rows too long for a varint CSR block");
+        c.rowOffset[u] = (uint32_t)rel;
+    }
+
+    #pragma omp parallel
+    {
+        std::vector<std::pair<int, Weight>> row;
+        #pragma omp for schedule(dynamic, 1024)
+        for (int u = 0; u < g.n; u++) {
+            sortedRow(g, u, row);
+            uint8_t* p = writeVarint(c.blob.data() + rowBytes[u], (uint32_t)row.size());
+            // the blob starts zeroed, OR each weight into the bytes it spans.
+            // Byte at a time so nothing outside this row's record is written
+            for (size_t i = 0; i < row.size() && c.width > 0; i++) {
+                ll bit = (ll)i * c.width;
+                uint64_t shifted = (uint64_t)((uint32_t)row[i].second - (uint32_t)lo) << (bit & 7);
+                int span = (int)(((bit & 7) + c.width + 7) >> 3);
+                for (int k = 0; k < span; k++) p[(bit >> 3) + k] |= (uint8_t)(shifted >> (8 * k));
+            }
+            p += ((ll)row.size() * c.width + 7) >> 3;
+            int prev = u;
+            for (size_t i = 0; i < row.size(); i++) {
+                p = writeVarint(p, i == 0 ? zigzag(row[i].first - prev) : (uint32_t)(row[i].first - prev));
+                prev = row[i].first;
+            }
+        }
+    }
+    return c;
+}
+
+const CompressedGraph& CompressedSolver::compressedFor(const Graph& g) {
+    if (g.is(compressedFrom)) return cg;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    cg = CompressedGraph::compress(g);
+    compressedFrom = g.identity();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (log) {
+        ll before = CompressedGraph::csrBytes(g);
+        *log << "[INFO] varint CSR: " << before << " -> " << cg.bytes() << " bytes (" << std::fixed
+             << std::setprecision(2) << (double)before / std::max<ll>(cg.bytes(), 1) << "x, "
+             << cg.weightBits() << "-bit weights), compressed in " << std::setprecision(3)
+             << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+    }
+    return cg;
+}
+
+std::string CompressedSolver::getName() {
+    switch (kind) {
+    case Kind::Dijkstra: return "Dijkstra (4-ary heap)";
+    case Kind::BFS: return "BFS";
+    case Kind::BellmanFord: return "Bellman-Ford";
+    }
+    return "?";
+}
+
+// the same loops as the plain serial solvers (serial_search.h), on
+// CompressedGraph's decoding neighbors(u)
+template <bool Parents>
+Result CompressedSolver::search(const CompressedGraph& c, int source) {
+    if (kind == Kind::BellmanFord) return bellmanFordSearch<Parents>(c, source, getName(), getType());
+
+    std::vector<int> parent(Parents ? c.n : 0, -1);
+    ResultView view = kind == Kind::Dijkstra
+        ? dijkstraSearch<Parents>(c, source, ws, pq, pqSize, parent.data(), getName(), getType())
+        : bfsSearch<Parents>(c, source, ws, parent.data(), getName(), getType());
+    Result r = view.toResult();
+    r.parents = std::move(parent);
+    return r;
+}
+
+Result CompressedSolver::solve(const Graph& g, int source) {
+    const CompressedGraph& c = compressedFor(g);
+    return parentsOn ? search<true>(c, source) : search<false>(c, source);
+}
@@ -40,35 +40,55 @@ vector<int> dijkstra(const Graph& graph, int source) {
     return dist;
 }
 
+// frontier-driven: each round only relaxes out of the vertices that changed
+// in the round before, and stops as soon as nothing did
 vector<int> bellman_ford(const Graph& graph, int source) {
     int n = graph.size();
     vector<int> dist(n, INF);
+    vector<int> frontier, next;
+    vector<char> queued(n, 0);
     dist[source] = 0;
+    frontier.push_back(source);
     
-    // Relax edges n-1 times
-    for (int i = 0; i < n - 1; i++) {
-        for (int u = 0; u < n; u++) {
-            if (dist[u] == INF) continue;
+    for (int i = 0; i < n - 1 && !frontier.empty(); i++) {
+        for (int u : frontier) {
             for (const Edge& edge : graph[u]) {
                 int v = edge.to;
                 int weight = edge.weight;
                 if (dist[u] + weight < dist[v]) {
                     dist[v] = dist[u] + weight;
+                    if (!queued[v]) {
+                        queued[v] = 1;
+                        next.push_back(v);
+                    }
                 }
             }
         }
+        for (int v : next) queued[v] = 0;
+        frontier.swap(next);
+        next.clear();
     }
     
-    // Check for negative cycles
-    for (int u = 0; u < n; u++) {
-        if (dist[u] == INF) continue;
+    // Check for negative cycles: only vertices that changed in the last
+    // round can still have an edge to relax, and every negative cycle has
+    // such an edge. Whatever those edges lead to has no shortest path
+    vector<int> doomed;
+    for (int u : frontier) {
         for (const Edge& edge : graph[u]) {
             int v = edge.to;
-            int weight = edge.weight;
-            if (dist[u] + weight < dist[v]) {
-                // Negative cycle detected
-                fill(dist.begin(), dist.end(), -INF);
-                return dist;
+            if (dist[v] != NEG_INF && dist[u] + edge.weight < dist[v]) {
+                dist[v] = NEG_INF;
+                doomed.push_back(v);
+            }
+        }
+    }
+    while (!doomed.empty()) {
+        int u = doomed.back();
+        doomed.pop_back();
+        for (const Edge& edge : graph[u]) {
+            if (dist[edge.to] != NEG_INF) {
+                dist[edge.to] = NEG_INF;
+                doomed.push_back(edge.to);
             }
         }
     }
@@ -115,7 +135,7 @@ vector<vector<int>> johnson(const Graph& graph) {
     vector<int> h = bellman_ford(extended_graph, n);
     
     // Check for negative cycles
-    if (!h.empty() && h[0] == -INF) {
+    if (find(h.begin(), h.end(), NEG_INF) != h.end()) {
         // Negative cycle detected, return empty matrix
         return vector<vector<int>>();
     }
@@ -198,7 +218,7 @@ vector<int> astar(const Graph& graph, int source, int target, const vector<int>&
 
 bool has_negative_cycle(const Graph& graph, int source) {
     vector<int> dist = bellman_ford(graph, source);
-    return !dist.empty() && dist[0] == -INF;
+    return find(dist.begin(), dist.end(), NEG_INF) != dist.end();
 }
 
 bool has_negative_weight(const Graph& graph) {
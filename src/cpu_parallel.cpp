@@ -1,215 +1,704 @@
 #include "../inc/algos.h"
+#include "../inc/relax.h"
+#include "../inc/worksteal.h"
 #include <omp.h>
 #include <queue>
 #include <deque>
 #include <algorithm>
 #include <chrono>
+#include <limits>
+#include <cstdint>
+#include <thread>
 
-Result DijkstraParallel::solve(const Graph& g, int source) {
+// every parallel solver is written once over Labels<Parents> (relax.h) and
+// solve() picks the instantiation, so without parents the search is the
+// same code it always was
+template <bool Parents>
+static Result dijkstraParallel(const Graph& g, int source, int num_threads) {
     auto start = std::chrono::high_resolution_clock::now();
     omp_set_num_threads(num_threads);
     
-    std::vector<Weight> dist(g.n, INF);
+    Labels<Parents> label(g.n);
     std::vector<bool> visited(g.n, false);
+    WorkTally tally;
     
-    dist[source] = 0;
+    label.set(source, 0, -1);
     
+    const unsigned long long NONE = std::numeric_limits<unsigned long long>::max();
     for (int iter = 0; iter < g.n; iter++) {
-        int u = -1;
-        Weight minDist = INF;
+        // pick next vertex with min dist but in parallel. (dist, v) is packed
+        // into one key so a plain min reduction gives us the argmin too
+        unsigned long long best = NONE;
         
-        // pick next vertex with min dist but in parallel
-        #pragma omp parallel for reduction(min:minDist) private(u)
+        #pragma omp parallel for reduction(min:best)
         for (int v = 0; v < g.n; v++) {
-            if (!visited[v] && dist[v] < minDist) {
-                minDist = dist[v];
-                u = v;
+            if (!visited[v] && label.peek(v) < INF) {
+                unsigned long long key = ((unsigned long long)(unsigned)label.peek(v) << 32) | (unsigned)v;
+                best = std::min(best, key);
             }
         }
         
-        if (minDist == INF) break;
+        if (best == NONE) break;
+        int u = (int)(best & 0xffffffffULL);
         visited[u] = true;
+        Weight du = label.peek(u);
         
-        //edge relaxation, TODO: see if this is right idk i think it is rn
-        #pragma omp parallel for
-        for (int e = 0; e < (int)g.adj[u].size(); e++) {
-            const auto& edge = g.adj[u][e];
-            if (dist[u] + edge.weight < dist[edge.to]) {
-                #pragma omp critical
-                {
-                    if (dist[u] + edge.weight < dist[edge.to]) {
-                        dist[edge.to] = dist[u] + edge.weight;
-                    }
-                }
-            }
+        const ll* off = g.offsets();
+        const int* to = g.targets();
+        const Weight* w = g.edgeWeights();
+        tally.pop();
+        tally.scan(off[u + 1] - off[u]);
+        
+        #pragma omp parallel for WORK_REDUCTION(tally)
+        for (ll e = off[u]; e < off[u + 1]; e++) {
+            if (label.relax(to[e], du + w[e], u)) tally.relax();
         }
     }
     
+    std::vector<Weight> dist = label.takeDistances();
+    std::vector<int> parents = label.takeParents();
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
     
-    return {dist, elapsed, "Dijkstra", "CPU Parallel (OpenMP)"};
+    Result r{std::move(dist), elapsed, "Dijkstra", "CPU Parallel (OpenMP)"};
+    tally.addTo(r.work);
+    r.parents = std::move(parents);
+    return r;
 }
 
-Result BellmanFordParallel::solve(const Graph& g, int source) {
+Result DijkstraParallel::solve(const Graph& g, int source) {
+    return parentsOn ? dijkstraParallel<true>(g, source, num_threads)
+                     : dijkstraParallel<false>(g, source, num_threads);
+}
+
+// frontier-driven like the serial one. Threads relax out of their share of
+// the frontier with atomicMin, whoever lowers a distance claims the vertex's
+// flag so it lands in the next frontier once, and the per-thread pieces are
+// concatenated at their prefix-sum offsets
+template <bool Parents>
+static Result bellmanFordParallel(const Graph& g, int source, int num_threads) {
     auto start = std::chrono::high_resolution_clock::now();
     omp_set_num_threads(num_threads);
     
-    std::vector<Weight> dist(g.n, INF);
-    dist[source] = 0;
-    
-    //  edge relaxation, n-1 times i think
-    for (int i = 0; i < g.n - 1; i++) {
-        #pragma omp parallel for
-        for (int u = 0; u < g.n; u++) {
-            if (dist[u] == INF) continue;
-            for (const auto& edge : g.adj[u]) {
-                if (dist[u] + edge.weight < dist[edge.to]) {
-                    #pragma omp critical
-                    {
-                        if (dist[u] + edge.weight < dist[edge.to]) {
-                            dist[edge.to] = dist[u] + edge.weight;
-                        }
+    Labels<Parents> label(g.n);
+    std::vector<int> frontier, next;
+    std::vector<char> queued(g.n, 0);
+    std::vector<std::vector<int>> local(num_threads);
+    std::vector<size_t> offsets(num_threads + 1, 0);
+    WorkCounters work;
+    WorkTally tally;
+    int rounds = 0;
+    ll touched = 0;
+    
+    label.set(source, 0, -1);
+    frontier.push_back(source);
+    tally.push();
+    
+    while (!frontier.empty() && rounds < g.n - 1) {
+        rounds++;
+        recordFrontier(work, (ll)frontier.size());
+        WorkTally round;
+        
+        #pragma omp parallel reduction(+:touched) WORK_REDUCTION(round)
+        {
+            const int tid = omp_get_thread_num();
+            const int nthreads = omp_get_num_threads();
+            auto& mine = local[tid];
+            mine.clear();
+            
+            #pragma omp for schedule(dynamic, 64) nowait
+            for (size_t i = 0; i < frontier.size(); i++) {
+                int u = frontier[i];
+                Weight du = label.load(u);
+                round.pop();
+                touched += g.degree(u);
+                for (const auto& edge : g.neighbors(u)) {
+                    round.scan();
+                    if (!label.relax(edge.to, du + edge.weight, u)) continue;
+                    round.relax();
+                    if (atomicLoad(&queued[edge.to]) == 0 && tryClaim(&queued[edge.to])) {
+                        mine.push_back(edge.to);
+                        round.push();
                     }
                 }
             }
+            
+            offsets[tid + 1] = mine.size();
+            #pragma omp barrier
+            #pragma omp single
+            {
+                offsets[0] = 0;
+                for (int t = 0; t < nthreads; t++) offsets[t + 1] += offsets[t];
+                next.resize(offsets[nthreads]);
+            }
+            std::copy(mine.begin(), mine.end(), next.begin() + offsets[tid]);
+            #pragma omp barrier
+            #pragma omp for schedule(static)
+            for (size_t i = 0; i < next.size(); i++) queued[next[i]] = 0;
         }
+        
+        frontier.swap(next);
+        tally += round;
     }
     
+    std::vector<Weight> dist = label.takeDistances();
+    std::vector<int> parents = label.takeParents();
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
     
-    return {dist, elapsed, "Bellman-Ford", "CPU Parallel (OpenMP)"};
+    tally.addTo(work);
+    countRequeues(work, dist.data(), g.n);
+    Result r{std::move(dist), elapsed, "Bellman-Ford", "CPU Parallel (OpenMP)"};
+    r.work = std::move(work);
+    r.rounds = rounds;
+    r.edges_touched = touched;
+    r.parents = std::move(parents);
+    return r;
 }
 
-Result BFSParallel::solve(const Graph& g, int source) {
+Result BellmanFordParallel::solve(const Graph& g, int source) {
+    return parentsOn ? bellmanFordParallel<true>(g, source, num_threads)
+                     : bellmanFordParallel<false>(g, source, num_threads);
+}
+
+// direction-optimizing BFS (Beamer et al.), switch thresholds from the paper
+static const int BFS_ALPHA = 15;
+static const int BFS_BETA = 18;
+
+// in-edges as CSR, bottom-up steps scan these
+static void buildTranspose(const Graph& g, std::vector<ll>& inPtr, std::vector<int>& inSrc) {
+    inPtr.assign(g.n + 1, 0);
+    inSrc.resize(g.m);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int u = 0; u < g.n; u++) {
+        for (const auto& edge : g.neighbors(u)) {
+            __atomic_fetch_add(&inPtr[edge.to + 1], 1, __ATOMIC_RELAXED);
+        }
+    }
+    for (int v = 0; v < g.n; v++) inPtr[v + 1] += inPtr[v];
+
+    std::vector<ll> cursor(inPtr.begin(), inPtr.end() - 1);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int u = 0; u < g.n; u++) {
+        for (const auto& edge : g.neighbors(u)) {
+            inSrc[__atomic_fetch_add(&cursor[edge.to], 1, __ATOMIC_RELAXED)] = u;
+        }
+    }
+}
+
+// top-down: expand the sparse queue, every thread fills its own local queue
+// and the locals get concatenated at their prefix-sum offsets. Returns the
+// out-degree sum of the new frontier (the "scout count")
+template <class L>
+static ll topDownStep(const Graph& g, L& label, Weight level,
+                      std::vector<int>& queue, std::vector<int>& next,
+                      std::vector<std::vector<int>>& local, std::vector<size_t>& offsets,
+                      WorkTally& tally) {
+    ll scout = 0;
+    WorkTally step;
+
+    #pragma omp parallel reduction(+:scout) WORK_REDUCTION(step)
+    {
+        const int tid = omp_get_thread_num();
+        const int nthreads = omp_get_num_threads();
+        auto& mine = local[tid];
+        mine.clear();
+
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (size_t i = 0; i < queue.size(); i++) {
+            int u = queue[i];
+            step.pop();
+            for (const auto& edge : g.neighbors(u)) {
+                step.scan();
+                if (label.load(edge.to) == INF && label.claim(edge.to, INF, level + 1, u)) {
+                    mine.push_back(edge.to);
+                    scout += g.degree(edge.to);
+                    step.relax();
+                    step.push();
+                }
+            }
+        }
+
+        offsets[tid + 1] = mine.size();
+        #pragma omp barrier
+        #pragma omp single
+        {
+            offsets[0] = 0;
+            for (int t = 0; t < nthreads; t++) offsets[t + 1] += offsets[t];
+            next.resize(offsets[nthreads]);
+        }
+        std::copy(mine.begin(), mine.end(), next.begin() + offsets[tid]);
+    }
+
+    queue.swap(next);
+    tally += step;
+    return scout;
+}
+
+// bottom-up: every unvisited vertex looks for a parent in the frontier
+// bitmap. Threads own whole 64-bit words of `next` so no atomics needed
+template <class L>
+static ll bottomUpStep(const Graph& g, L& label, Weight level,
+                       const std::vector<ll>& inPtr, const std::vector<int>& inSrc,
+                       const std::vector<uint64_t>& front, std::vector<uint64_t>& next,
+                       WorkTally& tally) {
+    ll awake = 0;
+    WorkTally step;
+
+    #pragma omp parallel for schedule(dynamic, 16) reduction(+:awake) WORK_REDUCTION(step)
+    for (size_t w = 0; w < next.size(); w++) {
+        uint64_t word = 0;
+        int base = (int)(w * 64);
+        int limit = std::min(g.n, base + 64);
+        for (int v = base; v < limit; v++) {
+            if (label.peek(v) != INF) continue;
+            for (ll i = inPtr[v]; i < inPtr[v + 1]; i++) {
+                int u = inSrc[i];
+                step.scan();
+                if (front[u >> 6] & (1ULL << (u & 63))) {
+                    label.set(v, level + 1, u);
+                    word |= 1ULL << (v & 63);
+                    awake++;
+                    step.relax();
+                    break;
+                }
+            }
+        }
+        next[w] = word;
+    }
+
+    tally += step;
+    return awake;
+}
+
+template <bool Parents>
+static Result bfsParallel(const Graph& g, int source, int num_threads) {
     auto start = std::chrono::high_resolution_clock::now();
     omp_set_num_threads(num_threads);
     
-    std::vector<Weight> dist(g.n, INF);
-    std::vector<int> current_level, next_level;
+    Labels<Parents> label(g.n);
+    std::vector<int> queue, next;
+    std::vector<std::vector<int>> local(num_threads);
+    std::vector<size_t> offsets(num_threads + 1, 0);
+    std::vector<uint64_t> front, next_bits;
+    std::vector<ll> inPtr;
+    std::vector<int> inSrc;
+    Weight level = 0;
+    WorkCounters work;
+    WorkTally tally;
     
-    dist[source] = 0;
-    current_level.push_back(source);
+    label.set(source, 0, -1);
+    queue.push_back(source);
     
-    while (!current_level.empty()) {
-        next_level.clear();
-        
-        #pragma omp parallel for
-        for (int idx = 0; idx < (int)current_level.size(); idx++) {
-            int u = current_level[idx];
-            for (const auto& edge : g.adj[u]) {
-                if (dist[edge.to] == INF) {
-                    #pragma omp critical
-                    {
-                        if (dist[edge.to] == INF) {
-                            dist[edge.to] = dist[u] + 1;
-                            next_level.push_back(edge.to);
-                        }
-                    }
+    ll scout = g.degree(source);
+    ll edges_to_check = g.m;
+    
+    while (!queue.empty()) {
+        if (scout > edges_to_check / BFS_ALPHA) {
+            // frontier got heavy, sweep bottom-up until it shrinks again
+            if (inPtr.empty()) buildTranspose(g, inPtr, inSrc);
+            size_t words = ((size_t)g.n + 63) / 64;
+            front.assign(words, 0);
+            next_bits.assign(words, 0);
+            for (int u : queue) front[u >> 6] |= 1ULL << (u & 63);
+            
+            ll awake = (ll)queue.size(), old_awake;
+            do {
+                recordFrontier(work, awake);
+                old_awake = awake;
+                awake = bottomUpStep(g, label, level, inPtr, inSrc, front, next_bits, tally);
+                front.swap(next_bits);
+                level++;
+            } while (awake >= old_awake || awake > g.n / BFS_BETA);
+            
+            // back to a sparse queue
+            queue.clear();
+            for (size_t w = 0; w < front.size(); w++) {
+                for (uint64_t word = front[w]; word; word &= word - 1) {
+                    queue.push_back((int)(w * 64) + __builtin_ctzll(word));
                 }
             }
+            scout = 1;
+        } else {
+            edges_to_check -= scout;
+            recordFrontier(work, (ll)queue.size());
+            scout = topDownStep(g, label, level, queue, next, local, offsets, tally);
+            level++;
         }
-        
-        current_level = next_level;
     }
     
+    std::vector<Weight> dist = label.takeDistances();
+    std::vector<int> parents = label.takeParents();
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
     
-    return {dist, elapsed, "BFS", "CPU Parallel (OpenMP)"};
+    tally.addTo(work);
+    Result r{std::move(dist), elapsed, "BFS", "CPU Parallel (OpenMP)"};
+    r.work = std::move(work);
+    r.parents = std::move(parents);
+    return r;
 }
 
-Result SPFAParallel::solve(const Graph& g, int source) {
-    auto start = std::chrono::high_resolution_clock::now();
-    omp_set_num_threads(num_threads);
-    
-    std::vector<Weight> dist(g.n, INF);
-    std::vector<int> inQueue(g.n, 0);
-    std::vector<std::deque<int>> buckets(4); // bucketing, might be bad tho
-    
-    dist[source] = 0;
-    buckets[0].push_back(source);
-    inQueue[source] = 1;
-    
-    for (int bucket_idx = 0; bucket_idx < 4; bucket_idx++) {
-        while (!buckets[bucket_idx].empty()) {
-            std::vector<int> batch(buckets[bucket_idx].begin(), buckets[bucket_idx].end());
-            buckets[bucket_idx].clear();
-            
-            #pragma omp parallel for
-            for (int idx = 0; idx < (int)batch.size(); idx++) {
-                int u = batch[idx];
-                inQueue[u] = 0;
-                
-                for (const auto& edge : g.adj[u]) {
-                    if (dist[u] != INF && dist[u] + edge.weight < dist[edge.to]) {
-                        #pragma omp critical
-                        {
-                            if (dist[u] + edge.weight < dist[edge.to]) {
-                                dist[edge.to] = dist[u] + edge.weight;
-                                if (!inQueue[edge.to]) {
-                                    buckets[(dist[edge.to] >> 8) % 4].push_back(edge.to);
-                                    inQueue[edge.to] = 1;
-                                }
-                            }
-                        }
+Result BFSParallel::solve(const Graph& g, int source) {
+    return parentsOn ? bfsParallel<true>(g, source, num_threads) : bfsParallel<false>(g, source, num_threads);
+}
+
+namespace {
+
+// SPFA's local order: Small Label First on push, Large Label Last on pop.
+// Labels are the ones a vertex was pushed with, later drops don't reorder it
+struct SLFLLLQueue {
+    std::deque<std::pair<int, Weight>> q;
+    ll sum = 0;
+
+    bool empty() const { return q.empty(); }
+    size_t size() const { return q.size(); }
+
+    void push(int v, Weight d, bool) {
+        if (!q.empty() && d < q.front().second) q.push_front({v, d});
+        else q.push_back({v, d});
+        sum += d;
+    }
+
+    int pop() {
+        // the front goes to the back while it's above the queue's mean
+        for (size_t k = 1; k < q.size() && (ll)q.front().second * (ll)q.size() > sum; k++) {
+            q.push_back(q.front());
+            q.pop_front();
+        }
+        auto [v, d] = q.front();
+        q.pop_front();
+        sum -= d;
+        return v;
+    }
+
+    int popBack() {
+        auto [v, d] = q.back();
+        q.pop_back();
+        sum -= d;
+        return v;
+    }
+};
+
+// Levit's local order (d'Esopo-Pape): a vertex that was already scanned once
+// goes to the front, its stale label has fed others that need fixing soon.
+// New ones go to the back. With several threads correcting the same region
+// plain Pape chases labels that are about to drop again, so a rescan only
+// jumps the queue if its label is also below the front's (SLF)
+struct PapeQueue {
+    std::deque<std::pair<int, Weight>> q;
+
+    bool empty() const { return q.empty(); }
+    size_t size() const { return q.size(); }
+
+    void push(int v, Weight d, bool scanned) {
+        if (scanned && (q.empty() || d < q.front().second)) q.push_front({v, d});
+        else q.push_back({v, d});
+    }
+
+    int pop() {
+        int v = q.front().first;
+        q.pop_front();
+        return v;
+    }
+
+    int popBack() {
+        int v = q.back().first;
+        q.pop_back();
+        return v;
+    }
+};
+
+}
+
+// Label-correcting search on work-stealing deques. Each thread works off a
+// private Local queue, which sets the order it scans in, and spills the
+// back half of it into its Chase-Lev deque when that runs dry while other
+// threads are idle. Out of local work a thread takes from its own deque and
+// then steals from the others. process(u, tally, local) scans u and queues
+// what it improved with local.push(v, d, hint).
+//
+// Termination: a thread that finds nothing anywhere counts itself idle and
+// only uncounts itself right before a steal attempt. An idle thread holds no
+// work and only owners push, so all threads idle at once means done.
+template <class Local, class Process>
+static void workStealingSearch(int threads, int source, WorkTally& tally, Process process) {
+    std::vector<ChaseLevDeque> shared(threads);
+    int idle = 0;
+
+    #pragma omp parallel num_threads(threads) WORK_REDUCTION(tally)
+    {
+        // OMP_THREAD_LIMIT, OMP_DYNAMIC or nesting can hand us fewer threads
+        // than asked for, and the idle count has to reach the real team size
+        int team = omp_get_num_threads();
+        int tid = omp_get_thread_num();
+        ChaseLevDeque& mine = shared[tid];
+        Local local;
+        unsigned seed = 2654435761u * (unsigned)(tid + 1);
+        if (tid == 0) local.push(source, 0, false);
+
+        for (;;) {
+            int u = !local.empty() ? local.pop() : mine.take();
+            if (u == ChaseLevDeque::EMPTY) {
+                __atomic_add_fetch(&idle, 1, __ATOMIC_SEQ_CST);
+                while (u == ChaseLevDeque::EMPTY) {
+                    if (__atomic_load_n(&idle, __ATOMIC_SEQ_CST) == team) break;
+                    seed ^= seed << 13;
+                    seed ^= seed >> 17;
+                    seed ^= seed << 5;
+                    for (int k = 0; k < team && u == ChaseLevDeque::EMPTY; k++) {
+                        int victim = (int)((seed + k) % team);
+                        if (victim == tid || shared[victim].empty()) continue;
+                        __atomic_sub_fetch(&idle, 1, __ATOMIC_SEQ_CST);
+                        u = shared[victim].steal();
+                        if (u == ChaseLevDeque::EMPTY) __atomic_add_fetch(&idle, 1, __ATOMIC_SEQ_CST);
                     }
+                    if (u == ChaseLevDeque::EMPTY) std::this_thread::yield();
                 }
+                if (u == ChaseLevDeque::EMPTY) break;
+            }
+
+            tally.pop();
+            process(u, tally, local);
+
+            // share on demand only. Spilled vertices lose their local order,
+            // and ones the owner gets back late often carried the best labels,
+            // which costs a lot of requeues
+            if (local.size() > 1 && mine.empty() && __atomic_load_n(&idle, __ATOMIC_RELAXED) > 0) {
+                for (size_t k = local.size() / 2; k > 0; k--) mine.push(local.popBack());
             }
         }
     }
-    
+}
+
+template <bool Parents>
+static Result spfaParallel(const Graph& g, int source, int num_threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Labels<Parents> label(g.n);
+    std::vector<char> inQueue(g.n, 0);
+    WorkCounters work;
+    WorkTally tally;
+
+    label.set(source, 0, -1);
+    inQueue[source] = 1;
+    tally.push();
+
+    workStealingSearch<SLFLLLQueue>(num_threads, source, tally, [&](int u, WorkTally& t, SLFLLLQueue& local) {
+        // flag release, this load, relax and claim are seq_cst: see releaseClaim
+        releaseClaim(&inQueue[u]);
+        Weight du = label.template load<__ATOMIC_SEQ_CST>(u);
+        for (const auto& edge : g.neighbors(u)) {
+            t.scan();
+            Weight nd = du + edge.weight;
+            if (!label.template relax<__ATOMIC_SEQ_CST>(edge.to, nd, u)) continue;
+            t.relax();
+            if (tryClaim<__ATOMIC_SEQ_CST>(&inQueue[edge.to])) {
+                local.push(edge.to, nd, false);
+                t.push();
+            }
+        }
+    });
+
+    std::vector<Weight> dist = label.takeDistances();
+    std::vector<int> parents = label.takeParents();
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
-    
-    return {dist, elapsed, "SPFA", "CPU Parallel (OpenMP)"};
+
+    tally.addTo(work);
+    countRequeues(work, dist.data(), g.n);
+    Result r{std::move(dist), elapsed, "SPFA", "CPU Parallel (OpenMP)"};
+    r.work = std::move(work);
+    r.parents = std::move(parents);
+    return r;
 }
 
-Result LevitParallel::solve(const Graph& g, int source) {
+Result SPFAParallel::solve(const Graph& g, int source) {
+    return parentsOn ? spfaParallel<true>(g, source, num_threads) : spfaParallel<false>(g, source, num_threads);
+}
+
+template <bool Parents>
+static Result levitParallel(const Graph& g, int source, int num_threads) {
     auto start = std::chrono::high_resolution_clock::now();
-    omp_set_num_threads(num_threads);
-    
-    std::vector<Weight> dist(g.n, INF);
+
+    Labels<Parents> label(g.n);
     std::vector<int> state(g.n, 0);  // 0: untouched, 1: active, 2: scanned
-    std::vector<std::deque<int>> active_set(num_threads);
-    
-    dist[source] = 0;
+    WorkCounters work;
+    WorkTally tally;
+
+    label.set(source, 0, -1);
     state[source] = 1;
-    active_set[0].push_back(source);
-    
-    bool has_active = true;
-    while (has_active) {
-        has_active = false;
-        
-        #pragma omp parallel for
-        for (int tid = 0; tid < num_threads; tid++) {
-            while (!active_set[tid].empty()) {
-                int u = active_set[tid].front();
-                active_set[tid].pop_front();
-                state[u] = 2;
-                
-                for (const auto& edge : g.adj[u]) {
-                    if (dist[u] + edge.weight < dist[edge.to]) {
-                        #pragma omp critical
-                        {
-                            if (dist[u] + edge.weight < dist[edge.to]) {
-                                dist[edge.to] = dist[u] + edge.weight;
-                                if (state[edge.to] == 0 || state[edge.to] == 2) {
-                                    state[edge.to] = 1;
-                                    active_set[tid % num_threads].push_back(edge.to);
-                                    has_active = true;
-                                }
-                            }
-                        }
+    tally.push();
+
+    workStealingSearch<PapeQueue>(num_threads, source, tally, [&](int u, WorkTally& t, PapeQueue& local) {
+        // seq_cst like in spfaParallel
+        releaseClaim(&state[u], 2);
+        Weight du = label.template load<__ATOMIC_SEQ_CST>(u);
+        for (const auto& edge : g.neighbors(u)) {
+            t.scan();
+            Weight nd = du + edge.weight;
+            if (!label.template relax<__ATOMIC_SEQ_CST>(edge.to, nd, u)) continue;
+            t.relax();
+            // untouched or scanned -> active, only one thread requeues it
+            if (tryClaim<__ATOMIC_SEQ_CST>(&state[edge.to], 0, 1)) {
+                local.push(edge.to, nd, false);
+                t.push();
+            } else if (tryClaim<__ATOMIC_SEQ_CST>(&state[edge.to], 2, 1)) {
+                local.push(edge.to, nd, true);
+                t.push();
+            }
+        }
+    });
+
+    std::vector<Weight> dist = label.takeDistances();
+    std::vector<int> parents = label.takeParents();
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    tally.addTo(work);
+    countRequeues(work, dist.data(), g.n);
+    Result r{std::move(dist), elapsed, "Levit", "CPU Parallel (OpenMP)"};
+    r.work = std::move(work);
+    r.parents = std::move(parents);
+    return r;
+}
+
+Result LevitParallel::solve(const Graph& g, int source) {
+    return parentsOn ? levitParallel<true>(g, source, num_threads) : levitParallel<false>(g, source, num_threads);
+}
+
+// pick delta from the weight range: roughly max_w / avg degree so each
+// bucket holds about one "hop" worth of light edges (Meyer & Sanders)
+Weight DeltaSteppingParallel::chooseDelta(const Graph& g) {
+    Weight min_w = INF, max_w = 0;
+
+    #pragma omp parallel for reduction(min:min_w) reduction(max:max_w) schedule(static)
+    for (int u = 0; u < g.n; u++) {
+        for (const auto& edge : g.neighbors(u)) {
+            min_w = std::min(min_w, edge.weight);
+            max_w = std::max(max_w, edge.weight);
+        }
+    }
+
+    if (g.m == 0 || max_w <= 0) return 1;
+    ll avg_degree = std::max<ll>(1, g.m / std::max(1, g.n));
+    Weight d = (Weight)std::max<ll>(1, max_w / avg_degree);
+    return std::max(d, std::max<Weight>(min_w, 1));
+}
+
+template <bool Parents>
+static Result deltaStepping(const Graph& g, int source, int num_threads, Weight delta) {
+    auto start = std::chrono::high_resolution_clock::now();
+    omp_set_num_threads(num_threads);
+
+    const Weight d = delta > 0 ? delta : DeltaSteppingParallel::chooseDelta(g);
+    const size_t NO_BUCKET = std::numeric_limits<size_t>::max();
+
+    Labels<Parents> label(g.n);
+    label.set(source, 0, -1);
+
+    // bins[tid][b] = vertices thread tid pushed into bucket b
+    std::vector<std::vector<std::vector<int>>> bins(num_threads);
+    std::vector<std::vector<int>> settled(num_threads);  // R set for the heavy phase
+    std::vector<size_t> counts(num_threads + 1, 0);
+    std::vector<size_t> next_bucket(num_threads, NO_BUCKET);
+    std::vector<int> frontier{source};
+    size_t cur = 0;
+    WorkCounters work;
+    WorkTally tally;
+    tally.push();
+    recordFrontier(work, 1);
+
+    #pragma omp parallel num_threads(num_threads) WORK_REDUCTION(tally)
+    {
+        const int tid = omp_get_thread_num();
+        const int nthreads = omp_get_num_threads();
+        auto& my_bins = bins[tid];
+        auto& my_settled = settled[tid];
+
+        auto relax = [&](int u, int v, Weight nd) {
+            tally.scan();
+            if (label.relax(v, nd, u)) {
+                size_t b = (size_t)(nd / d);
+                if (b >= my_bins.size()) my_bins.resize(b + 1);
+                my_bins[b].push_back(v);
+                tally.relax();
+                tally.push();
+            }
+        };
+
+        // concat every thread's bins[*][cur] into the shared frontier
+        auto gather = [&]() {
+            counts[tid + 1] = cur < my_bins.size() ? my_bins[cur].size() : 0;
+            #pragma omp barrier
+            #pragma omp single
+            {
+                counts[0] = 0;
+                for (int t = 0; t < nthreads; t++) counts[t + 1] += counts[t];
+                frontier.resize(counts[nthreads]);
+                if (counts[nthreads] > 0) recordFrontier(work, (ll)counts[nthreads]);
+            }
+            if (cur < my_bins.size()) {
+                std::copy(my_bins[cur].begin(), my_bins[cur].end(), frontier.begin() + counts[tid]);
+                my_bins[cur].clear();
+            }
+            #pragma omp barrier
+        };
+
+        while (cur != NO_BUCKET) {
+            // light phase: keep emptying bucket cur, it can refill itself
+            while (!frontier.empty()) {
+                #pragma omp for schedule(dynamic, 64)
+                for (size_t i = 0; i < frontier.size(); i++) {
+                    int u = frontier[i];
+                    Weight du = label.load(u);
+                    tally.pop();
+                    if ((size_t)(du / d) != cur) continue;  // stale entry
+                    my_settled.push_back(u);
+                    for (const auto& edge : g.neighbors(u)) {
+                        if (edge.weight <= d) relax(u, edge.to, du + edge.weight);
                     }
                 }
+                gather();
             }
+
+            // heavy phase: once per bucket, heavy edges can't land back in cur
+            for (int u : my_settled) {
+                Weight du = label.load(u);
+                for (const auto& edge : g.neighbors(u)) {
+                    if (edge.weight > d) relax(u, edge.to, du + edge.weight);
+                }
+            }
+            my_settled.clear();
+
+            size_t nb = NO_BUCKET;
+            for (size_t b = cur + 1; b < my_bins.size(); b++) {
+                if (!my_bins[b].empty()) { nb = b; break; }
+            }
+            next_bucket[tid] = nb;
+            #pragma omp barrier
+            #pragma omp single
+            cur = *std::min_element(next_bucket.begin(), next_bucket.begin() + nthreads);
+
+            if (cur != NO_BUCKET) gather();
         }
     }
-    
+
+    std::vector<Weight> dist = label.takeDistances();
+    std::vector<int> parents = label.takeParents();
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
-    
-    return {dist, elapsed, "Levit", "CPU Parallel (OpenMP)"};
-}
\ No newline at end of file
+
+    tally.addTo(work);
+    countRequeues(work, dist.data(), g.n);
+    Result r{std::move(dist), elapsed, "Delta-Stepping", "CPU Parallel (OpenMP)"};
+    r.work = std::move(work);
+    r.parents = std::move(parents);
+    return r;
+}
+
+Result DeltaSteppingParallel::solve(const Graph& g, int source) {
+    return parentsOn ? deltaStepping<true>(g, source, num_threads, delta)
+                     : deltaStepping<false>(g, source, num_threads, delta);
+}
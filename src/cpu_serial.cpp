@@ -1,15 +1,21 @@
 #include "../inc/algos.h"
+#include "../inc/serial_search.h"
 #include <queue>
 #include <cstring>
 #include <algorithm>
 #include <deque>
 #include <chrono>
 
-Result DijkstraSerial::solve(const Graph& g, int source) {
+// the serial solvers keep parent[] only in their Parents instantiation (the
+// vector stays empty otherwise), solve() picks which one runs
+template <bool Parents>
+static Result dijkstraSerial(const Graph& g, int source) {
     auto start = std::chrono::high_resolution_clock::now();
     
     std::vector<Weight> dist(g.n, INF);
+    std::vector<int> parent(Parents ? g.n : 0, -1);
     std::vector<bool> visited(g.n, false);
+    WorkTally tally;
     
     dist[source] = 0;
     
@@ -23,10 +29,14 @@ Result DijkstraSerial::solve(const Graph& g, int source) {
         
         if (dist[u] == INF) break;
         visited[u] = true;
+        tally.pop();  // the linear scan is this version's extract-min
         
-        for (const auto& edge : g.adj[u]) {
+        for (const auto& edge : g.neighbors(u)) {
+            tally.scan();
             if (dist[u] + edge.weight < dist[edge.to]) {
                 dist[edge.to] = dist[u] + edge.weight;
+                if constexpr (Parents) parent[edge.to] = u;
+                tally.relax();
             }
         }
     }
@@ -34,66 +44,76 @@ Result DijkstraSerial::solve(const Graph& g, int source) {
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
     
-    return {dist, elapsed, "Dijkstra", "CPU Serial"};
+    Result r{std::move(dist), elapsed, "Dijkstra", "CPU Serial"};
+    tally.addTo(r.work);
+    r.parents = std::move(parent);
+    return r;
+}
+
+Result DijkstraSerial::solve(const Graph& g, int source) {
+    return parentsOn ? dijkstraSerial<true>(g, source) : dijkstraSerial<false>(g, source);
+}
+
+template <class Queue>
+template <bool Parents>
+ResultView DijkstraHeap<Queue>::search(const Graph& g, int source, SolverWorkspace& ws, int* parent) {
+    return dijkstraSearch<Parents>(g, source, ws, pq, pqSize, parent, getName(), getType());
+}
+
+template <class Queue>
+ResultView DijkstraHeap<Queue>::solveInto(const Graph& g, int source, SolverWorkspace& ws) {
+    return search<false>(g, source, ws, nullptr);
+}
+
+template <class Queue>
+Result DijkstraHeap<Queue>::solve(const Graph& g, int source) {
+    SolverWorkspace ws;
+    if (!parentsOn) return search<false>(g, source, ws, nullptr).toResult();
+    std::vector<int> parent(g.n, -1);
+    Result r = search<true>(g, source, ws, parent.data()).toResult();
+    r.parents = std::move(parent);
+    return r;
+}
+
+template class DijkstraHeap<DAryHeap<4>>;
+template class DijkstraHeap<PairingHeap>;
+template class DijkstraHeap<RadixHeap>;
+
+template <bool Parents>
+static Result bellmanFordSerial(const Graph& g, int source) {
+    return bellmanFordSearch<Parents>(g, source, "Bellman-Ford", "CPU Serial");
 }
 
 Result BellmanFordSerial::solve(const Graph& g, int source) {
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    std::vector<Weight> dist(g.n, INF);
-    dist[source] = 0;
-    
-    // Relax edges n-1 times
-    for (int i = 0; i < g.n - 1; i++) {
-        for (int u = 0; u < g.n; u++) {
-            if (dist[u] == INF) continue;
-            for (const auto& edge : g.adj[u]) {
-                if (dist[u] + edge.weight < dist[edge.to]) {
-                    dist[edge.to] = dist[u] + edge.weight;
-                }
-            }
-        }
-    }
-    
-    auto end = std::chrono::high_resolution_clock::now();
-    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
-    
-    return {dist, elapsed, "Bellman-Ford", "CPU Serial"};
+    return parentsOn ? bellmanFordSerial<true>(g, source) : bellmanFordSerial<false>(g, source);
+}
+
+template <bool Parents>
+static ResultView bfsSerial(const Graph& g, int source, SolverWorkspace& ws, int* parent) {
+    return bfsSearch<Parents>(g, source, ws, parent, "BFS", "CPU Serial");
+}
+
+ResultView BFSSerial::solveInto(const Graph& g, int source, SolverWorkspace& ws) {
+    return bfsSerial<false>(g, source, ws, nullptr);
+}
+
+Result BFSSerial::solve(const Graph& g, int source) {
+    SolverWorkspace ws;
+    if (!parentsOn) return bfsSerial<false>(g, source, ws, nullptr).toResult();
+    std::vector<int> parent(g.n, -1);
+    Result r = bfsSerial<true>(g, source, ws, parent.data()).toResult();
+    r.parents = std::move(parent);
+    return r;
 }
 
-// Result BFSSerial::solve(const Graph& g, int source) {
-//     auto start = std::chrono::high_resolution_clock::now();
-    
-//     std::vector<Weight> dist(g.n, INF);
-//     std::queue<int> q;
-    
-//     dist[source] = 0;
-//     q.push(source);
-    
-//     while (!q.empty()) {
-//         int u = q.front();
-//         q.pop();
-        
-//         for (const auto& edge : g.adj[u]) {
-//             if (dist[edge.to] > dist[u] + 1) {
-//                 dist[edge.to] = dist[u] + 1;
-//                 q.push(edge.to);
-//             }
-//         }
-//     }
-    
-//     auto end = std::chrono::high_resolution_clock::now();
-//     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
-    
-//     return {dist, elapsed, "BFS", "CPU Serial"};
-// }
 class BFSExpanded : public SSSPSolver {
 public:
     Result solve(const Graph& g, int source) override {
         auto start = std::chrono::high_resolution_clock::now();
         
-        Graph expanded = g.expandForBFS(g);
+        Graph expanded = g.expandForBFS();
         std::vector<Weight> dist(expanded.n, INF);
+        std::vector<int> via(parentsOn ? expanded.n : 0, -1);  // BFS parent in expanded
         std::queue<int> q;
         dist[source] = 0;
         q.push(source);
@@ -102,9 +122,10 @@ public:
             int u = q.front();
             q.pop();
             
-            for (const auto& edge : expanded.adj[u]) {
+            for (const auto& edge : expanded.neighbors(u)) {
                 if (dist[edge.to] == INF) {
                     dist[edge.to] = dist[u] + 1;
+                    if (parentsOn) via[edge.to] = u;
                     q.push(edge.to);
                 }
             }
@@ -115,38 +136,68 @@ public:
             result_dist[i] = dist[i];
         }
         
+        // back up the chain of dummy vertices to the real tail of the edge
+        std::vector<int> parent(parentsOn ? g.n : 0, -1);
+        for (size_t i = 0; i < parent.size(); i++) {
+            int p = via[i];
+            while (p >= g.n) p = via[p];
+            parent[i] = p;
+        }
+        
         auto end = std::chrono::high_resolution_clock::now();
         double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
         
-        return {result_dist, elapsed, "BFS (Expanded)", "CPU Serial"};
+        Result r{std::move(result_dist), elapsed, "BFS (Expanded)", "CPU Serial"};
+        r.parents = std::move(parent);
+        return r;
     }
     
     std::string getName() override { return "BFS (Expanded)"; }
     std::string getType() override { return "CPU Serial"; }
 };
 
-Result SPFASerial::solve(const Graph& g, int source) {
+template <bool Parents>
+static ResultView spfaSerial(const Graph& g, int source, SolverWorkspace& ws, int* parent) {
     auto start = std::chrono::high_resolution_clock::now();
     
-    std::vector<Weight> dist(g.n, INF);
-    std::vector<int> inQueue(g.n, 0);
-    std::deque<int> q;
+    ws.prepare(g.n);
+    Weight* dist = ws.dist;
+    char* inQueue = ws.flag;
+    int* q = ws.queue;  // ring buffer, a vertex is queued at most once
+    int head = 0, tail = 0, cap = g.n + 1;
+    WorkCounters work;
+    WorkTally tally;
+    // a generation is what was queued when the previous one finished, the
+    // FIFO equivalent of a Bellman-Ford pass
+    int genLeft = 1, genSize = 1;
     
-    dist[source] = 0;
-    q.push_back(source);
+    ws.reach(source, 0);
+    q[tail++] = source;
     inQueue[source] = 1;
+    tally.push();
     
-    while (!q.empty()) {
-        int u = q.front();
-        q.pop_front();
+    while (head != tail) {
+        if (genLeft == 0) {
+            recordFrontier(work, genSize);
+            genSize = genLeft = (tail - head + cap) % cap;
+        }
+        genLeft--;
+        int u = q[head];
+        head = head + 1 == cap ? 0 : head + 1;
         inQueue[u] = 0;
+        tally.pop();
         
-        for (const auto& edge : g.adj[u]) {
-            if (dist[u] != INF && dist[u] + edge.weight < dist[edge.to]) {
-                dist[edge.to] = dist[u] + edge.weight;
+        for (const auto& edge : g.neighbors(u)) {
+            tally.scan();
+            if (dist[u] + edge.weight < dist[edge.to]) {
+                ws.reach(edge.to, dist[u] + edge.weight);
+                if constexpr (Parents) parent[edge.to] = u;
+                tally.relax();
                 if (!inQueue[edge.to]) {
-                    q.push_back(edge.to);
+                    q[tail] = edge.to;
+                    tail = tail + 1 == cap ? 0 : tail + 1;
                     inQueue[edge.to] = 1;
+                    tally.push();
                 }
             }
         }
@@ -155,19 +206,39 @@ Result SPFASerial::solve(const Graph& g, int source) {
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
     
-    return {dist, elapsed, "SPFA", "CPU Serial"};
+    recordFrontier(work, genSize);
+    tally.addTo(work);
+    countRequeues(work, dist, g.n);
+    return {ws.view(), elapsed, "SPFA", "CPU Serial", std::move(work)};
 }
 
-Result LevitSerial::solve(const Graph& g, int source) {
+ResultView SPFASerial::solveInto(const Graph& g, int source, SolverWorkspace& ws) {
+    return spfaSerial<false>(g, source, ws, nullptr);
+}
+
+Result SPFASerial::solve(const Graph& g, int source) {
+    SolverWorkspace ws;
+    if (!parentsOn) return spfaSerial<false>(g, source, ws, nullptr).toResult();
+    std::vector<int> parent(g.n, -1);
+    Result r = spfaSerial<true>(g, source, ws, parent.data()).toResult();
+    r.parents = std::move(parent);
+    return r;
+}
+
+template <bool Parents>
+static Result levitSerial(const Graph& g, int source) {
     auto start = std::chrono::high_resolution_clock::now();
     
     std::vector<Weight> dist(g.n, INF);
+    std::vector<int> parent(Parents ? g.n : 0, -1);
     std::vector<int> state(g.n, 0);  // 0: untouched, 1: active, 2: scanned
     std::deque<int> active;
+    WorkTally tally;
     
     dist[source] = 0;
     state[source] = 1;
     active.push_back(source);
+    tally.push();
     
     while (!active.empty()) {
         int u = active.front();
@@ -183,6 +254,7 @@ Result LevitSerial::solve(const Graph& g, int source) {
         
         if (process_front) {
             active.pop_front();
+            tally.pop();
         } else {
             active.erase(std::find(active.begin(), active.end(), u));
             active.push_front(u);
@@ -191,15 +263,20 @@ Result LevitSerial::solve(const Graph& g, int source) {
         
         state[u] = 2;
         // hopefully works lol
-        for (const auto& edge : g.adj[u]) {
+        for (const auto& edge : g.neighbors(u)) {
+            tally.scan();
             if (dist[u] + edge.weight < dist[edge.to]) {
                 dist[edge.to] = dist[u] + edge.weight;
+                if constexpr (Parents) parent[edge.to] = u;
+                tally.relax();
                 if (state[edge.to] == 0) {
                     active.push_back(edge.to);
                     state[edge.to] = 1;
+                    tally.push();
                 } else if (state[edge.to] == 2) {
                     state[edge.to] = 1;
                     active.push_back(edge.to);
+                    tally.push();
                 }
             }
         }
@@ -208,5 +285,13 @@ Result LevitSerial::solve(const Graph& g, int source) {
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
     
-    return {dist, elapsed, "Levit", "CPU Serial"};
+    Result r{std::move(dist), elapsed, "Levit", "CPU Serial"};
+    tally.addTo(r.work);
+    countRequeues(r.work, r.distances.data(), g.n);
+    r.parents = std::move(parent);
+    return r;
+}
+
+Result LevitSerial::solve(const Graph& g, int source) {
+    return parentsOn ? levitSerial<true>(g, source) : levitSerial<false>(g, source);
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "../inc/incremental.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+static void checkEdge(int n, int u, int v, Weight w) {
+    if (u < 0 || u >= n || v < 0 || v >= n) {
+        throw std::runtime_error("[ERR] Edge " + std::to_string(u) + " -> " + std::to_string(v) + " out of range");
+    }
+    if (w < 0) throw std::runtime_error("[ERR] Incremental SSSP needs non-negative weights");
+}
+
+DynamicGraph::DynamicGraph(const Graph& g) : n(g.n), out(g.n), in(g.n) {
+    std::vector<int> indeg(g.n, 0);
+    for (int u = 0; u < g.n; u++) {
+        auto& row = out[u];
+        for (const auto& e : g.neighbors(u)) {
+            checkEdge(n, u, e.to, e.weight);
+            row.push_back(e);
+        }
+        // cheapest of each group of parallel edges
+        std::sort(row.begin(), row.end(), [](const Edge& a, const Edge& b) {
+            return a.to != b.to ? a.to < b.to : a.weight < b.weight;
+        });
+        row.erase(std::unique(row.begin(), row.end(), [](const Edge& a, const Edge& b) { return a.to == b.to; }),
+                  row.end());
+        for (const auto& e : row) indeg[e.to]++;
+        m += (ll)row.size();
+    }
+    for (int v = 0; v < g.n; v++) in[v].reserve(indeg[v]);
+    for (int u = 0; u < g.n; u++) {
+        for (const auto& e : out[u]) in[e.to].push_back({u, e.weight});
+    }
+}
+
+// the entry for `to` in list, nullptr if there is none
+static Edge* findEdge(std::vector<Edge>& list, int to) {
+    for (auto& e : list) {
+        if (e.to == to) return &e;
+    }
+    return nullptr;
+}
+
+static void eraseEdge(std::vector<Edge>& list, int to) {
+    Edge* e = findEdge(list, to);
+    *e = list.back();
+    list.pop_back();
+}
+
+Weight DynamicGraph::set(int u, int v, Weight w) {
+    checkEdge(n, u, v, w);
+    Edge* e = findEdge(out[u], v);
+    if (!e) {
+        out[u].push_back({v, w});
+        in[v].push_back({u, w});
+        m++;
+        return INF;
+    }
+    Weight old = e->weight;
+    e->weight = w;
+    findEdge(in[v], u)->weight = w;
+    return old;
+}
+
+Weight DynamicGraph::remove(int u, int v) {
+    checkEdge(n, u, v, 0);
+    Edge* e = findEdge(out[u], v);
+    if (!e) return INF;
+    Weight old = e->weight;
+    eraseEdge(out[u], v);
+    eraseEdge(in[v], u);
+    m--;
+    return old;
+}
+
+Weight DynamicGraph::weight(int u, int v) const {
+    for (const auto& e : out[u]) {
+        if (e.to == v) return e.weight;
+    }
+    return INF;
+}
+
+Graph DynamicGraph::toGraph() const {
+    std::vector<ll> rowPtr(n + 1, 0);
+    for (int u = 0; u < n; u++) rowPtr[u + 1] = rowPtr[u] + (ll)out[u].size();
+    std::vector<int> col(m);
+    std::vector<Weight> w(m);
+    for (int u = 0; u < n; u++) {
+        ll i = rowPtr[u];
+        for (const auto& e : out[u]) {
+            col[i] = e.to;
+            w[i++] = e.weight;
+        }
+    }
+    return Graph(n, std::move(rowPtr), std::move(col), std::move(w));
+}
+
+IncrementalSSSP::IncrementalSSSP(const Graph& g, int source)
+    : dg(g), src(source), dist(g.n, INF), parent(g.n, -1), invalid(g.n, 0) {
+    if (source < 0 || source >= g.n) {
+        throw std::runtime_error("[ERR] Source " + std::to_string(source) + " out of range");
+    }
+    pq.reset(g.n);
+    UpdateStats stats;
+    dist[src] = 0;
+    pq.push(src, 0);
+    settle(stats);
+}
+
+// Dijkstra from whatever is queued. Only strict improvements are taken, so
+// parent stays a tree
+void IncrementalSSSP::settle(UpdateStats& stats) {
+    while (!pq.empty()) {
+        auto [du, u] = pq.pop();
+        stats.settled++;
+        for (const auto& e : dg.outEdges(u)) {
+            stats.scanned++;
+            Weight nd = du + e.weight;
+            if (nd < dist[e.to]) {
+                dist[e.to] = nd;
+                parent[e.to] = u;
+                pq.push(e.to, nd);
+            }
+        }
+    }
+}
+
+UpdateStats IncrementalSSSP::apply(const std::vector<EdgeUpdate>& batch) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    UpdateStats stats;
+    stats.updates = (int)batch.size();
+    std::vector<int> roots;                       // heads of tree edges that got heavier or went away
+    std::vector<std::pair<int, int>> lighter;     // edges that got lighter or appeared
+
+    for (const auto& up : batch) {
+        Weight old = up.kind == EdgeUpdate::DELETE ? dg.remove(up.u, up.v) : dg.set(up.u, up.v, up.w);
+        Weight now = up.kind == EdgeUpdate::DELETE ? INF : up.w;
+        if (now > old) {
+            // parallel edges are merged, so (parent[v], v) is the tree edge
+            if (parent[up.v] == up.u) roots.push_back(up.v);
+        } else if (now < old) {
+            lighter.push_back({up.u, up.v});
+        }
+    }
+
+    // invalidate: everything whose tree path runs through a root. A child
+    // whose own tree edge was deleted is a root itself
+    std::vector<int> region;
+    for (int r : roots) {
+        if (invalid[r]) continue;
+        invalid[r] = 1;
+        stack.push_back(r);
+        while (!stack.empty()) {
+            int x = stack.back();
+            stack.pop_back();
+            region.push_back(x);
+            for (const auto& e : dg.outEdges(x)) {
+                stats.scanned++;
+                if (parent[e.to] == x && !invalid[e.to]) {
+                    invalid[e.to] = 1;
+                    stack.push_back(e.to);
+                }
+            }
+        }
+    }
+    stats.invalidated = (int)region.size();
+    for (int x : region) {
+        dist[x] = INF;
+        parent[x] = -1;
+    }
+
+    // best way back in from the part of the tree that's still valid
+    for (int x : region) {
+        for (const auto& e : dg.inEdges(x)) {
+            stats.scanned++;
+            int y = e.to;
+            if (invalid[y] || dist[y] == INF) continue;
+            if (dist[y] + e.weight < dist[x]) {
+                dist[x] = dist[y] + e.weight;
+                parent[x] = y;
+            }
+        }
+    }
+    for (int x : region) {
+        invalid[x] = 0;
+        if (dist[x] != INF) pq.push(x, dist[x]);
+    }
+
+    // lighter edges: the final weight counts, the batch may touch an edge twice
+    for (const auto& [u, v] : lighter) {
+        if (dist[u] == INF) continue;
+        Weight w = dg.weight(u, v);
+        if (w != INF && dist[u] + w < dist[v]) {
+            dist[v] = dist[u] + w;
+            parent[v] = u;
+            pq.push(v, dist[v]);
+        }
+    }
+
+    settle(stats);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return stats;
+}
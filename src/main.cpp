@@ -1,132 +1,587 @@
 #include "../inc/algos.h"
+#include "../inc/graph_io.h"
+#include "../inc/reorder.h"
+#include "../inc/perf.h"
+#include "../inc/paths.h"
 #include <iostream>
 #include <fstream>
-// #include <memory>
+#include <sstream>
+#include <memory>
 #include <iomanip>
+#include <random>
+#include <cmath>
 
+struct Options {
+    std::string graph_file;
+    std::vector<std::string> solvers;  // registry keys, empty = all
+    std::vector<int> sources;
+    int random_sources = 0;
+    unsigned long long seed = 1;
+    std::vector<int> threads = {8};
+    int warmup = 1;
+    int reps = 5;
+    std::string ordering = "none";
+    std::string format = "table";      // table, csv, json
+    std::string output;                // empty = stdout
+    bool verify = true;
+    bool perf = false;                 // hardware counters through perf_event_open
+    bool parents = false;              // track, check and sample shortest-path trees
+};
 
+// one (solver, thread count) configuration, over every source and rep
+struct Row {
+    std::string key, algorithm, implementation;
+    int threads;
+    size_t samples;
+    double median, p95, mean, stddev, min;
+    double mteps;       // median over samples of reached edges / time
+    double reorder_ms;
+    bool correct;
+    HardwareCounters hw;  // medians over samples, -1 if not measured
+    WorkCounters work;    // medians over samples, frontier from the first one
+};
 
-bool verifyResults(const std::vector<Weight>& dist1, const std::vector<Weight>& dist2) {
-    if (dist1.size() != dist2.size()) return false;
-    for (size_t i = 0; i < dist1.size(); i++) {
-        if (dist1[i] != dist2[i]) return false;
+static void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " <graph_file> [source_vertex] [ordering] [options]\n"
+              << "  --solvers a,b,...     registry keys (default: all):\n                       ";
+    for (const auto& e : solverRegistry()) std::cout << " " << e.key;
+    std::cout << "\n"
+              << "  --sources a,b,...     source vertices (default 0)\n"
+              << "  --random-sources N    N sources sampled from vertices with out-edges\n"
+              << "  --seed S              seed for --random-sources (default 1)\n"
+              << "  --threads a,b,...     thread counts for parallel solvers, a list is a sweep (default 8)\n"
+              << "  --warmup W            untimed runs per source (default 1)\n"
+              << "  --reps N              timed runs per source (default 5)\n"
+              << "  --ordering NAME       none (default), degree, rcm, bfs, dfs, hub\n"
+              << "  --format F            table (default), csv, json\n"
+              << "  --output FILE         write the csv/json/table there instead of stdout\n"
+              << "  --no-verify           skip comparing distances against the first solver\n"
+              << "  --perf                read cycles, instructions, LLC/dTLB/branch misses per run\n"
+              << "  --parents             have every solver build its shortest-path tree, check each\n"
+              << "                        tree against the distances and print sample paths\n";
+}
+
+static std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream in(s);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+static std::vector<int> parseInts(const std::string& s) {
+    std::vector<int> out;
+    for (const auto& item : splitList(s)) out.push_back(std::stoi(item));
+    return out;
+}
+
+static Options parseArgs(int argc, char* argv[]) {
+    Options o;
+    o.graph_file = argv[1];
+    int i = 2;
+    // old positional form: <graph_file> [source_vertex] [ordering]
+    if (i < argc && argv[i][0] != '-') o.sources = {atoi(argv[i++])};
+    if (i < argc && argv[i][0] != '-') o.ordering = argv[i++];
+
+    for (; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--no-verify") {
+            o.verify = false;
+            continue;
+        }
+        if (flag == "--perf") {
+            o.perf = true;
+            continue;
+        }
+        if (flag == "--parents") {
+            o.parents = true;
+            continue;
+        }
+        if (i + 1 >= argc) throw std::runtime_error("[ERR] Missing value for " + flag);
+        std::string value = argv[++i];
+        if (flag == "--solvers") o.solvers = splitList(value);
+        else if (flag == "--sources") o.sources = parseInts(value);
+        else if (flag == "--random-sources") o.random_sources = std::stoi(value);
+        else if (flag == "--seed") o.seed = std::stoull(value);
+        else if (flag == "--threads") o.threads = parseInts(value);
+        else if (flag == "--warmup") o.warmup = std::stoi(value);
+        else if (flag == "--reps") o.reps = std::stoi(value);
+        else if (flag == "--ordering") o.ordering = value;
+        else if (flag == "--format") o.format = value;
+        else if (flag == "--output") o.output = value;
+        else throw std::runtime_error("[ERR] Unknown option: " + flag);
+    }
+
+    if (o.format != "table" && o.format != "csv" && o.format != "json") {
+        throw std::runtime_error("[ERR] Unknown format: " + o.format + " (table, csv, json)");
+    }
+    if (o.reps < 1 || o.warmup < 0) throw std::runtime_error("[ERR] Need --reps >= 1 and --warmup >= 0");
+    if (o.threads.empty()) throw std::runtime_error("[ERR] Need at least one thread count");
+    for (int t : o.threads) {
+        if (t < 1) throw std::runtime_error("[ERR] Thread counts must be >= 1");
+    }
+    return o;
+}
+
+// nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = (size_t)std::ceil(p * sorted.size());
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t k = v.size() / 2;
+    return v.size() % 2 ? v[k] : (v[k - 1] + v[k]) / 2;
+}
+
+// median of one counter over the runs that have it, -1 if none do
+template <typename T>
+static T medianCounter(const std::vector<HardwareCounters>& runs, T HardwareCounters::*field) {
+    std::vector<double> v;
+    for (const auto& hw : runs) {
+        if (hw.*field >= 0) v.push_back((double)(hw.*field));
+    }
+    return v.empty() ? (T)-1 : (T)median(v);
+}
+
+static HardwareCounters medianCounters(const std::vector<HardwareCounters>& runs) {
+    HardwareCounters m;
+    m.cycles = medianCounter(runs, &HardwareCounters::cycles);
+    m.instructions = medianCounter(runs, &HardwareCounters::instructions);
+    m.llc_misses = medianCounter(runs, &HardwareCounters::llc_misses);
+    m.dtlb_misses = medianCounter(runs, &HardwareCounters::dtlb_misses);
+    m.branch_misses = medianCounter(runs, &HardwareCounters::branch_misses);
+    m.task_clock_ms = medianCounter(runs, &HardwareCounters::task_clock_ms);
+    return m;
+}
+
+static WorkCounters medianWork(const std::vector<WorkCounters>& runs) {
+    WorkCounters m;
+    if (runs.empty()) return m;
+    auto field = [&](ll WorkCounters::*f) {
+        std::vector<double> v;
+        for (const auto& w : runs) v.push_back((double)(w.*f));
+        return (ll)median(v);
+    };
+    m.edges_scanned = field(&WorkCounters::edges_scanned);
+    m.relaxations = field(&WorkCounters::relaxations);
+    m.requeues = field(&WorkCounters::requeues);
+    m.pushes = field(&WorkCounters::pushes);
+    m.pops = field(&WorkCounters::pops);
+    m.frontier = runs[0].frontier;
+    return m;
+}
+
+static ll maxFrontier(const WorkCounters& w) {
+    return w.frontier.empty() ? 0 : *std::max_element(w.frontier.begin(), w.frontier.end());
+}
+
+static uint64_t hashDistances(const std::vector<Weight>& dist) {
+    return fnv1a(dist.data(), dist.size() * sizeof(Weight));
+}
+
+// out-edges of every vertex the source reaches, the TEPS numerator
+static ll reachedEdges(const Graph& g, const std::vector<Weight>& dist) {
+    ll edges = 0;
+    for (int v = 0; v < g.n; v++) {
+        if (dist[v] != INF) edges += g.degree(v);
+    }
+    return edges;
+}
+
+static std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+static void writeTable(std::ostream& out, const std::vector<Row>& rows) {
+    out << std::left
+        << std::setw(40) << "Implementation"
+        << std::setw(28) << "Algorithm"
+        << std::right
+        << std::setw(8) << "Threads"
+        << std::setw(14) << "Median (ms)"
+        << std::setw(12) << "p95 (ms)"
+        << std::setw(12) << "Stddev"
+        << std::setw(10) << "MTEPS"
+        << std::setw(10) << "Speedup"
+        << "\n";
+    out << std::string(134, '-') << "\n";
+
+    for (const auto& r : rows) {
+        out << std::left
+            << std::setw(40) << r.implementation
+            << std::setw(28) << r.algorithm
+            << std::right << std::fixed
+            << std::setw(8) << r.threads
+            << std::setw(14) << std::setprecision(3) << r.median
+            << std::setw(12) << std::setprecision(3) << r.p95
+            << std::setw(12) << std::setprecision(3) << r.stddev
+            << std::setw(10) << std::setprecision(1) << r.mteps
+            << std::setw(9) << std::setprecision(2) << (r.median > 0 ? rows[0].median / r.median : 0) << "x"
+            << (r.correct ? "" : "  INCORRECT")
+            << "\n";
+    }
+}
+
+// only the columns something was measured for
+static void writeCounterTable(std::ostream& out, const std::vector<Row>& rows) {
+    HardwareCounters seen;
+    for (const auto& r : rows) {
+        seen.cycles = std::max(seen.cycles, r.hw.cycles);
+        seen.instructions = std::max(seen.instructions, r.hw.instructions);
+        seen.llc_misses = std::max(seen.llc_misses, r.hw.llc_misses);
+        seen.dtlb_misses = std::max(seen.dtlb_misses, r.hw.dtlb_misses);
+        seen.branch_misses = std::max(seen.branch_misses, r.hw.branch_misses);
+        seen.task_clock_ms = std::max(seen.task_clock_ms, r.hw.task_clock_ms);
+    }
+    auto counter = [&](ll v) { return v >= 0 ? std::to_string(v) : std::string("-"); };
+
+    out << std::left << std::setw(40) << "Implementation" << std::setw(28) << "Algorithm" << std::right
+        << std::setw(8) << "Threads";
+    if (seen.cycles >= 0) out << std::setw(16) << "Cycles";
+    if (seen.instructions >= 0) out << std::setw(16) << "Instructions";
+    if (seen.cycles >= 0 && seen.instructions >= 0) out << std::setw(7) << "IPC";
+    if (seen.llc_misses >= 0) out << std::setw(14) << "LLC misses";
+    if (seen.dtlb_misses >= 0) out << std::setw(14) << "dTLB misses";
+    if (seen.branch_misses >= 0) out << std::setw(14) << "Br misses";
+    if (seen.task_clock_ms >= 0) out << std::setw(14) << "CPU (ms)";
+    out << "\n" << std::string(134, '-') << "\n";
+
+    for (const auto& r : rows) {
+        out << std::left << std::setw(40) << r.implementation << std::setw(28) << r.algorithm << std::right
+            << std::setw(8) << r.threads;
+        if (seen.cycles >= 0) out << std::setw(16) << counter(r.hw.cycles);
+        if (seen.instructions >= 0) out << std::setw(16) << counter(r.hw.instructions);
+        if (seen.cycles >= 0 && seen.instructions >= 0) {
+            if (r.hw.cycles > 0 && r.hw.instructions >= 0) {
+                out << std::setw(7) << std::fixed << std::setprecision(2) << (double)r.hw.instructions / r.hw.cycles;
+            } else {
+                out << std::setw(7) << "-";
+            }
+        }
+        if (seen.llc_misses >= 0) out << std::setw(14) << counter(r.hw.llc_misses);
+        if (seen.dtlb_misses >= 0) out << std::setw(14) << counter(r.hw.dtlb_misses);
+        if (seen.branch_misses >= 0) out << std::setw(14) << counter(r.hw.branch_misses);
+        if (seen.task_clock_ms >= 0) {
+            if (r.hw.task_clock_ms >= 0) out << std::setw(14) << std::fixed << std::setprecision(3) << r.hw.task_clock_ms;
+            else out << std::setw(14) << "-";
+        }
+        out << "\n";
+    }
+}
+
+// only in builds with SSSP_WORK_COUNTERS
+static void writeWorkTable(std::ostream& out, const std::vector<Row>& rows) {
+    out << std::left << std::setw(40) << "Implementation" << std::setw(28) << "Algorithm" << std::right
+        << std::setw(8) << "Threads" << std::setw(14) << "Edges" << std::setw(14) << "Relaxations"
+        << std::setw(12) << "Requeues" << std::setw(12) << "Pushes" << std::setw(12) << "Pops"
+        << std::setw(8) << "Rounds" << std::setw(12) << "Max front"
+        << "\n" << std::string(160, '-') << "\n";
+    for (const auto& r : rows) {
+        out << std::left << std::setw(40) << r.implementation << std::setw(28) << r.algorithm << std::right
+            << std::setw(8) << r.threads << std::setw(14) << r.work.edges_scanned
+            << std::setw(14) << r.work.relaxations << std::setw(12) << r.work.requeues
+            << std::setw(12) << r.work.pushes << std::setw(12) << r.work.pops
+            << std::setw(8) << r.work.frontier.size() << std::setw(12) << maxFrontier(r.work) << "\n";
+    }
+}
+
+static void writeCSV(std::ostream& out, const std::vector<Row>& rows, const Options& o, const Graph& g) {
+    out << "graph,n,m,solver,algorithm,implementation,threads,ordering,samples,"
+        << "median_ms,p95_ms,mean_ms,stddev_ms,min_ms,mteps,reorder_ms,correct,"
+        << "cycles,instructions,llc_misses,dtlb_misses,branch_misses,task_clock_ms,"
+        << "edges_scanned,relaxations,requeues,pushes,pops,rounds,max_frontier\n";
+    for (const auto& r : rows) {
+        out << o.graph_file << "," << g.n << "," << g.m << "," << r.key << ",\"" << r.algorithm << "\",\""
+            << r.implementation << "\"," << r.threads << "," << o.ordering << "," << r.samples << ","
+            << r.median << "," << r.p95 << "," << r.mean << "," << r.stddev << "," << r.min << ","
+            << r.mteps << "," << r.reorder_ms << "," << (r.correct ? 1 : 0) << ","
+            << r.hw.cycles << "," << r.hw.instructions << "," << r.hw.llc_misses << ","
+            << r.hw.dtlb_misses << "," << r.hw.branch_misses << "," << r.hw.task_clock_ms;
+        // -1 like the hw columns when the build has no work counters
+        if (WORK_COUNTERS_ENABLED) {
+            out << "," << r.work.edges_scanned << "," << r.work.relaxations << "," << r.work.requeues << ","
+                << r.work.pushes << "," << r.work.pops << "," << r.work.frontier.size() << ","
+                << maxFrontier(r.work) << "\n";
+        } else {
+            out << ",-1,-1,-1,-1,-1,-1,-1\n";
+        }
+    }
+}
+
+static void writeJSON(std::ostream& out, const std::vector<Row>& rows, const Options& o, const Graph& g,
+                      const std::vector<int>& sources) {
+    out << "{\n  \"graph\": " << jsonString(o.graph_file) << ", \"n\": " << g.n << ", \"m\": " << g.m
+        << ", \"ordering\": " << jsonString(o.ordering) << ", \"warmup\": " << o.warmup
+        << ", \"reps\": " << o.reps << ",\n  \"sources\": [";
+    for (size_t i = 0; i < sources.size(); i++) out << (i ? ", " : "") << sources[i];
+    out << "],\n  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Row& r = rows[i];
+        out << "    {\"solver\": " << jsonString(r.key) << ", \"algorithm\": " << jsonString(r.algorithm)
+            << ", \"implementation\": " << jsonString(r.implementation) << ", \"threads\": " << r.threads
+            << ", \"samples\": " << r.samples << ", \"median_ms\": " << r.median << ", \"p95_ms\": " << r.p95
+            << ", \"mean_ms\": " << r.mean << ", \"stddev_ms\": " << r.stddev << ", \"min_ms\": " << r.min
+            << ", \"mteps\": " << r.mteps << ", \"reorder_ms\": " << r.reorder_ms
+            << ", \"cycles\": " << r.hw.cycles << ", \"instructions\": " << r.hw.instructions
+            << ", \"llc_misses\": " << r.hw.llc_misses << ", \"dtlb_misses\": " << r.hw.dtlb_misses
+            << ", \"branch_misses\": " << r.hw.branch_misses << ", \"task_clock_ms\": " << r.hw.task_clock_ms;
+        if (WORK_COUNTERS_ENABLED) {
+            out << ", \"work\": {\"edges_scanned\": " << r.work.edges_scanned << ", \"relaxations\": "
+                << r.work.relaxations << ", \"requeues\": " << r.work.requeues << ", \"pushes\": "
+                << r.work.pushes << ", \"pops\": " << r.work.pops << ", \"frontier\": [";
+            for (size_t k = 0; k < r.work.frontier.size(); k++) out << (k ? ", " : "") << r.work.frontier[k];
+            out << "]}";
+        }
+        out << ", \"correct\": " << (r.correct ? "true" : "false") << "}" << (i + 1 < rows.size() ? "," : "")
+            << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// "0 -> 4 -> 9", long paths cut down to their ends
+static std::string describePath(const PathSet& paths, size_t i) {
+    const int* p = paths.begin(i);
+    ll len = paths.end(i) - p;
+    std::ostringstream out;
+    for (ll k = 0; k < len; k++) {
+        if (len > 8 && k == 3) {
+            out << " -> ...";
+            k = len - 4;
+            continue;
+        }
+        out << (k ? " -> " : "") << p[k];
     }
-    return true;
+    if (len > 8) out << " (" << paths.hops(i) << " hops)";
+    return out.str();
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <graph_file> [source_vertex]\n";
+    if (argc < 2 || std::string(argv[1]) == "--help") {
+        usage(argv[0]);
         return 1;
     }
 
-    std::string graph_file = argv[1];
-    int source = (argc > 2) ? atoi(argv[2]) : 0;
-
     try {
+        Options opt = parseArgs(argc, argv);
+        // with csv/json on stdout the progress lines go to stderr
+        std::ostream& log = opt.format == "table" || !opt.output.empty() ? std::cout : std::cerr;
+
+        std::vector<const SolverEntry*> selected;
+        if (opt.solvers.empty()) {
+            for (const auto& e : solverRegistry()) selected.push_back(&e);
+        } else {
+            for (const auto& key : opt.solvers) selected.push_back(&findSolver(key));
+        }
+
         // Load graph
-        std::cout << "[INFO] Loading graph from: " << graph_file << "\n";
-        Graph g = Graph::loadFromFile(graph_file);
-        std::cout << "[INFO] Graph loaded: " << g.n << " vertices, " << g.m << " edges\n";
-        
-        if (source < 0 || source >= g.n) {
-            std::cerr << "[ERR] Invalid source vertex\n";
-            return 1;
-        }
-
-        // Create solvers
-        std::vector<std::unique_ptr<SSSPSolver>> solvers;
-        
-        // CPU Serial
-        solvers.push_back(std::make_unique<DijkstraSerial>());
-        solvers.push_back(std::make_unique<BellmanFordSerial>());
-        solvers.push_back(std::make_unique<BFSSerial>());
-        solvers.push_back(std::make_unique<SPFASerial>());
-        solvers.push_back(std::make_unique<LevitSerial>());
-        
-        // CPU Parallel (8 threads)
-        solvers.push_back(std::make_unique<DijkstraParallel>(8));
-        solvers.push_back(std::make_unique<BellmanFordParallel>(8));
-        solvers.push_back(std::make_unique<BFSParallel>(8));
-        solvers.push_back(std::make_unique<SPFAParallel>(8));
-        solvers.push_back(std::make_unique<LevitParallel>(8));
-
-        // Benchmark and store results
-        std::cout << "\n" << std::string(100, '=') << "\n";
-        std::cout << "RUNNING BENCHMARKS\n";
-        std::cout << std::string(100, '=') << "\n\n";
-
-        std::vector<Result> results;
-        Result baseline;
-        bool first = true;
-
-        for (auto& solver : solvers) {
-            std::cout << "Running " << solver->getType() << " - " << solver->getName() << "... ";
-            std::cout.flush();
-            
-            auto result = solver->solve(g, source);
-            results.push_back(result);
-
-            if (first) {
-                baseline = result;
-                first = false;
-            } else {
-                if (!verifyResults(baseline.distances, result.distances)) {
-                    std::cout << "INCORRECT RESULT!\n";
-                    continue;
-                }
+        log << "[INFO] Loading graph from: " << opt.graph_file << "\n";
+        Graph g = loadGraph(opt.graph_file);  // text or binary CSR
+        log << "[INFO] Graph loaded: " << g.n << " vertices, " << g.m << " edges\n";
+
+        // sources: explicit list, random sample, or vertex 0
+        std::vector<int> sources = opt.sources;
+        if (opt.random_sources > 0) {
+            std::vector<int> candidates;
+            for (int v = 0; v < g.n; v++) if (g.degree(v) > 0) candidates.push_back(v);
+            if (candidates.empty()) for (int v = 0; v < g.n; v++) candidates.push_back(v);
+            std::mt19937_64 rng(opt.seed);
+            for (int i = 0; i < opt.random_sources && !candidates.empty(); i++) {
+                sources.push_back(candidates[rng() % candidates.size()]);
             }
+        }
+        if (sources.empty()) sources = {0};
+        for (int s : sources) {
+            if (s < 0 || s >= g.n) {
+                std::cerr << "[ERR] Invalid source vertex " << s << "\n";
+                return 1;
+            }
+        }
+
+        // optional relabelling, done once and shared by every solver
+        std::shared_ptr<const Reordering> order;
+        Ordering kind = parseOrdering(opt.ordering);
+        if (kind != Ordering::None) {
+            order = std::make_shared<const Reordering>(Reordering::compute(g, kind, sources[0]));
+            log << "[INFO] Reordered vertices (" << opt.ordering << ") in "
+                << std::fixed << std::setprecision(3) << order->time_ms << " ms\n";
+        }
+
+        log << "\n" << std::string(100, '=') << "\n";
+        log << "RUNNING BENCHMARKS (" << sources.size() << " source(s), " << opt.warmup << " warm-up, "
+            << opt.reps << " timed runs each)\n";
+        log << std::string(100, '=') << "\n\n";
 
-            std::cout << std::fixed << std::setprecision(3) << result.time_ms << " ms\n";
+        // the first configuration's answer per source is the reference
+        std::vector<uint64_t> refHash(sources.size(), 0);
+        std::vector<ll> refEdges(sources.size(), 0);
+        std::vector<Weight> sample_dist;
+        std::vector<int> sample_parents;
+        bool haveRef = false;
+
+        // one session for every solver, probed up front so the log says
+        // which counters this machine gives us
+        std::shared_ptr<PerfSession> perf;
+        if (opt.perf) {
+            perf = std::make_shared<PerfSession>();
+            perf->start();
+            perf->stop();
+            log << "[INFO] perf counters: " << perf->describe() << "\n\n";
         }
+        std::vector<Row> rows;
+
+        for (const SolverEntry* entry : selected) {
+            std::vector<int> counts = entry->parallel ? opt.threads : std::vector<int>{1};
+            for (int threads : counts) {
+                std::unique_ptr<SSSPSolver> solver = entry->make(threads);
+                if (perf) solver = std::make_unique<PerfCountedSolver>(perf, std::move(solver));
+                if (order) solver = std::make_unique<ReorderedSolver>(order, std::move(solver));
+                if (opt.parents) solver->setTrackParents(true);
+
+                log << "Running " << solver->getType() << " - " << solver->getName();
+                if (entry->parallel) log << " (" << threads << " threads)";
+                log << "... ";
+                log.flush();
 
+                std::vector<double> times, teps;
+                std::vector<HardwareCounters> counters;
+                std::vector<WorkCounters> work;
+                bool correct = true;
+                std::string treeError;
+                double reorder_ms = 0;
+                int rounds = -1;
+                ll touched = -1;
+                for (size_t i = 0; i < sources.size(); i++) {
+                    for (int run = 0; run < opt.warmup + opt.reps; run++) {
+                        Result r = solver->solve(g, sources[i]);
+                        reorder_ms = r.reorder_ms;
 
-        std::cout << "\n" << std::string(100, '=') << "\n";
-        std::cout << "RESULTS SUMMARY\n";
-        std::cout << std::string(100, '=') << "\n\n";
+                        if (run == 0) {
+                            if (opt.parents && treeError.empty()) {
+                                treeError = validateParents(g, sources[i], r.distances, r.parents);
+                                if (!treeError.empty()) correct = false;
+                            }
+                            if (!haveRef && i == 0 && opt.parents) sample_parents = r.parents;
+                            if (!haveRef) {
+                                refHash[i] = hashDistances(r.distances);
+                                refEdges[i] = reachedEdges(g, r.distances);
+                                if (i == 0) sample_dist.assign(r.distances.begin(), r.distances.begin() + std::min(10, g.n));
+                            } else if (opt.verify && hashDistances(r.distances) != refHash[i]) {
+                                correct = false;
+                            }
+                        }
+                        if (run < opt.warmup) continue;
 
-        std::cout << std::left 
-                  << std::setw(25) << "Implementation" 
-                  << std::setw(20) << "Algorithm"
-                  << std::setw(15) << "Time (ms)"
-                  << std::setw(15) << "Speedup vs Serial"
-                  << "\n";
-        
-        std::cout << std::string(75, '-') << "\n";
+                        if (times.empty()) {
+                            rounds = r.rounds;
+                            touched = r.edges_touched;
+                        }
+                        times.push_back(r.time_ms);
+                        counters.push_back(r.hw);
+                        if (!work.empty()) r.work.frontier.clear();  // only the first run's is kept
+                        work.push_back(std::move(r.work));
+                        teps.push_back(r.time_ms > 0 ? refEdges[i] / (r.time_ms * 1e3) : 0);
+                    }
+                }
+                haveRef = true;
+
+                std::vector<double> sorted = times;
+                std::sort(sorted.begin(), sorted.end());
+                double mean = 0, var = 0;
+                for (double t : times) mean += t;
+                mean /= times.size();
+                for (double t : times) var += (t - mean) * (t - mean);
+                double stddev = times.size() > 1 ? std::sqrt(var / (times.size() - 1)) : 0;
 
-        double serial_time = results[0].time_ms;
+                // auto may have run a serial engine or fewer threads than asked
+                int ran = solver->threadsUsed() > 0 ? solver->threadsUsed() : threads;
+                Row row = {entry->key, solver->getName(), solver->getType(), ran, times.size(),
+                           median(times), percentile(sorted, 0.95), mean, stddev, sorted[0],
+                           median(teps), reorder_ms, correct, medianCounters(counters), medianWork(work)};
+                rows.push_back(row);
 
-        for (const auto& result : results) {
-            double speedup = serial_time / result.time_ms;
-            std::cout << std::left
-                      << std::setw(25) << result.implementation_type
-                      << std::setw(20) << result.algorithm_name
-                      << std::setw(15) << std::fixed << std::setprecision(3) << result.time_ms
-                      << std::setw(15) << std::fixed << std::setprecision(2) << speedup << "x"
-                      << "\n";
+                if (!correct) log << "INCORRECT RESULT! ";
+                if (!treeError.empty()) log << "(bad tree: " << treeError << ") ";
+                log << std::fixed << std::setprecision(3) << row.median << " ms median";
+                if (rounds >= 0) {
+                    // what n-1 full sweeps would have looked at, for scale
+                    log << " (" << rounds << " rounds, " << touched << " edges touched vs "
+                        << std::setprecision(0) << (double)std::max(g.n - 1, 0) * g.m << " for n-1 full passes)";
+                }
+                log << "\n";
+            }
+        }
+
+        std::ofstream file;
+        if (!opt.output.empty()) {
+            file.open(opt.output);
+            if (!file.is_open()) throw std::runtime_error("[ERR] Cannot open file: " + opt.output);
         }
+        std::ostream& out = opt.output.empty() ? std::cout : file;
 
-        std::cout << "\n[INFO] Baseline (reference): " << results[0].implementation_type 
-                  << " - " << results[0].algorithm_name << " = " 
-                  << std::fixed << std::setprecision(3) << results[0].time_ms << " ms\n";
+        if (opt.format == "csv") writeCSV(out, rows, opt, g);
+        else if (opt.format == "json") writeJSON(out, rows, opt, g, sources);
+        else {
+            out << "\n" << std::string(100, '=') << "\n";
+            out << "RESULTS SUMMARY\n";
+            out << std::string(100, '=') << "\n\n";
+            writeTable(out, rows);
+            if (perf) {
+                out << "\nHARDWARE COUNTERS (median per run)\n\n";
+                writeCounterTable(out, rows);
+            }
+            if (WORK_COUNTERS_ENABLED) {
+                out << "\nWORK COUNTERS (median per run, rounds from the first run)\n\n";
+                writeWorkTable(out, rows);
+            }
+        }
+
+        log << "\n[INFO] Baseline (reference): " << rows[0].implementation << " - " << rows[0].algorithm
+            << " = " << std::fixed << std::setprecision(3) << rows[0].median << " ms median\n";
+        if (order) {
+            log << "[INFO] Reorder time (" << opt.ordering << ", one-off, not in the times above): "
+                << std::fixed << std::setprecision(3) << order->time_ms << " ms\n";
+        }
 
         // Sample distances for verification
-        std::cout << "\n[INFO] Sample distances from source " << source << ":\n";
-        for (int i = 0; i < std::min(10, g.n); i++) {
-            if (baseline.distances[i] == INF) {
-                std::cout << "  dist[" << i << "] = INF\n";
+        log << "\n[INFO] Sample distances from source " << sources[0] << ":\n";
+        PathSet samplePaths;
+        if (!sample_parents.empty()) {
+            std::vector<int> targets(sample_dist.size());
+            for (size_t i = 0; i < targets.size(); i++) targets[i] = (int)i;
+            try {
+                samplePaths = extractPaths(sample_parents, sources[0], targets);
+            } catch (const std::exception&) {
+                // a broken tree, already reported on its solver's line
+            }
+        }
+        for (size_t i = 0; i < sample_dist.size(); i++) {
+            if (sample_dist[i] == INF) {
+                log << "  dist[" << i << "] = INF\n";
+            } else if (sample_dist[i] == NEG_INF) {
+                log << "  dist[" << i << "] = -INF\n";
             } else {
-                std::cout << "  dist[" << i << "] = " << baseline.distances[i] << "\n";
+                log << "  dist[" << i << "] = " << sample_dist[i];
+                if (i < samplePaths.size() && samplePaths.reached(i)) log << "  via " << describePath(samplePaths, i);
+                log << "\n";
             }
         }
 
-        std::cout << "\n[INFO] Benchmark complete.\n";
+        log << "\n[INFO] Benchmark complete.\n";
+        log << "[DONE] we done yippee!\n";
 
     } catch (const std::exception& e) {
-        std::cerr << "[ERR] " << e.what() << "\n";
+        std::cerr << e.what() << "\n";
         return 1;
     }
 
-    std::cout << "[DONE] we done yippee!\n";
     return 0;
-}
\ No newline at end of file
+}
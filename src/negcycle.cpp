@@ -0,0 +1,176 @@
+#include "../inc/negcycle.h"
+#include "../inc/relax.h"
+#include <omp.h>
+#include <deque>
+#include <algorithm>
+
+namespace {
+
+// tree state for subtree disassembly. prev/next thread the tree in preorder,
+// so the subtree of v is v plus the run after it with greater depth
+struct ThreadedTree {
+    std::vector<int> parent, depth, prev, next;
+    std::vector<char> inTree;
+
+    explicit ThreadedTree(int n) : parent(n, -1), depth(n, 0), prev(n, -1), next(n, -1), inTree(n, 0) {}
+
+    // parent[x] is left as it was: a disassembly that runs into u still
+    // has to walk u's parents back up through the part it already cut
+    void unlink(int x) {
+        if (prev[x] != -1) next[prev[x]] = next[x];
+        if (next[x] != -1) prev[next[x]] = prev[x];
+        prev[x] = next[x] = -1;
+        inTree[x] = 0;
+    }
+
+    // v goes right after u in the thread, as u's first child
+    void hangUnder(int v, int u) {
+        parent[v] = u;
+        depth[v] = depth[u] + 1;
+        prev[v] = u;
+        next[v] = next[u];
+        if (next[u] != -1) prev[next[u]] = v;
+        next[u] = v;
+        inTree[v] = 1;
+    }
+};
+
+}
+
+// everything reachable from seeds gets NEG_INF, returns the newly marked ones
+static std::vector<int> markReachable(const Graph& g, std::vector<Weight>& dist,
+                                      const std::vector<int>& seeds, int threads) {
+    std::vector<int> marked, frontier;
+    for (int s : seeds) {
+        if (dist[s] != NEG_INF) {
+            dist[s] = NEG_INF;
+            frontier.push_back(s);
+        }
+    }
+    std::vector<std::vector<int>> local(threads);
+    while (!frontier.empty()) {
+        marked.insert(marked.end(), frontier.begin(), frontier.end());
+        #pragma omp parallel num_threads(threads)
+        {
+            auto& mine = local[omp_get_thread_num()];
+            mine.clear();
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < frontier.size(); i++) {
+                for (const auto& edge : g.neighbors(frontier[i])) {
+                    Weight d = atomicLoad(&dist[edge.to]);
+                    // claiming the slot itself, exactly one thread queues each vertex
+                    if (d != NEG_INF && tryClaim(&dist[edge.to], d, NEG_INF)) mine.push_back(edge.to);
+                }
+            }
+        }
+        frontier.clear();
+        for (const auto& mine : local) frontier.insert(frontier.end(), mine.begin(), mine.end());
+    }
+    return marked;
+}
+
+Result NegativeCycleSolver::solve(const Graph& g, int source) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<Weight> dist(g.n, INF);
+    std::vector<char> queued(g.n, 0);
+    std::deque<int> fifo;
+    ThreadedTree tree(g.n);
+    WorkTally tally;
+    found.clear();
+
+    dist[source] = 0;
+    tree.inTree[source] = 1;
+    fifo.push_back(source);
+    queued[source] = 1;
+    tally.push();
+
+    std::vector<int> cycle;
+    while (!fifo.empty()) {
+        int u = fifo.front();
+        fifo.pop_front();
+        tally.pop();
+        // dropped from the queue by a disassembly or a NEG_INF pass
+        if (!queued[u]) continue;
+        queued[u] = 0;
+
+        for (const auto& edge : g.neighbors(u)) {
+            tally.scan();
+            int v = edge.to;
+            Weight nd = dist[u] + edge.weight;
+            if (dist[v] == NEG_INF || nd >= dist[v]) continue;
+            dist[v] = nd;
+            tally.relax();
+
+            // cut the subtree of v loose, watching for u in it
+            cycle.clear();
+            if (v == u) {
+                cycle.push_back(v);
+            } else if (tree.inTree[v]) {
+                int x = tree.next[v];
+                while (x != -1 && tree.depth[x] > tree.depth[v]) {
+                    int after = tree.next[x];
+                    if (x == u) {
+                        for (int y = u; y != v; y = tree.parent[y]) cycle.push_back(y);
+                        cycle.push_back(v);
+                        std::reverse(cycle.begin(), cycle.end());
+                        break;
+                    }
+                    tree.unlink(x);
+                    queued[x] = 0;
+                    x = after;
+                }
+                if (cycle.empty()) tree.unlink(v);
+            }
+
+            if (!cycle.empty()) {
+                found.push_back(cycle);
+                for (int x : markReachable(g, dist, cycle, num_threads)) {
+                    if (tree.inTree[x]) tree.unlink(x);
+                    queued[x] = 0;
+                }
+                if (dist[u] == NEG_INF) break;  // u's other edges only lead to NEG_INF now
+                continue;
+            }
+
+            tree.hangUnder(v, u);
+            if (!queued[v]) {
+                queued[v] = 1;
+                fifo.push_back(v);
+                tally.push();
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    if (log && !found.empty() && found[0] != logged) {
+        logged = found[0];
+        Weight total = 0;
+        *log << "[INFO] " << found.size() << " negative cycle" << (found.size() == 1 ? "" : "s")
+             << " from source " << source << ", first: ";
+        for (size_t i = 0; i < logged.size(); i++) {
+            int a = logged[i], b = logged[(i + 1) % logged.size()];
+            Weight best = INF;
+            for (const auto& edge : g.neighbors(a)) {
+                if (edge.to == b) best = std::min(best, edge.weight);
+            }
+            total += best;
+            *log << a << " -> ";
+        }
+        *log << logged[0] << " (weight " << total << ")\n";
+    }
+
+    Result r{std::move(dist), elapsed, getName(), getType()};
+    tally.addTo(r.work);
+    if (parentsOn) {
+        // the tree already tracks them. Every finite label was last set by
+        // hangUnder, -INF ones have no path to give
+        r.parents = std::move(tree.parent);
+        for (int v = 0; v < g.n; v++) {
+            if (v == source || r.distances[v] == INF || r.distances[v] == NEG_INF) r.parents[v] = -1;
+        }
+    }
+    return r;
+}
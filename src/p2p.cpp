@@ -0,0 +1,338 @@
+#include "../inc/p2p.h"
+#include "../inc/graph_io.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <stdexcept>
+
+// full Dijkstra from s, for the landmark tables
+static void dijkstraFrom(const Graph& g, int s, std::vector<Weight>& dist, DAryHeap<4>& pq) {
+    dist.assign(g.n, INF);
+    pq.reset(g.n);
+    dist[s] = 0;
+    pq.push(s, 0);
+    while (!pq.empty()) {
+        auto [du, u] = pq.pop();
+        for (auto e : g.neighbors(u)) {
+            Weight nd = du + e.weight;
+            if (nd < dist[e.to]) {
+                dist[e.to] = nd;
+                pq.push(e.to, nd);
+            }
+        }
+    }
+}
+
+static void requireNonNegative(const Graph& g) {
+    const Weight* w = g.edgeWeights();
+    for (ll e = 0; e < g.m; e++) {
+        if (w[e] < 0) throw runtime_error("[ERR] Point-to-point queries need non-negative weights");
+    }
+}
+
+static uint64_t graphChecksum(const Graph& g) {
+    uint64_t h = fnv1a(g.offsets(), (g.n + 1) * sizeof(ll));
+    h = fnv1a(g.targets(), g.m * sizeof(int), h);
+    return fnv1a(g.edgeWeights(), g.m * sizeof(Weight), h);
+}
+
+LandmarkTable LandmarkTable::build(const Graph& g, const Graph& rev, int k, int seed) {
+    auto start = std::chrono::high_resolution_clock::now();
+    requireNonNegative(g);
+
+    LandmarkTable t;
+    t.n = g.n;
+    t.k = std::max(0, std::min(k, g.n));
+    t.from.resize((size_t)t.n * t.k);
+    t.to.resize((size_t)t.n * t.k);
+
+    // score[v] = min over picked landmarks of d(L,v) + d(v,L), INF counts as
+    // far so unreached parts of the graph get a landmark too
+    std::vector<ll> score(g.n, std::numeric_limits<ll>::max());
+    std::vector<Weight> fwd, bwd;
+    DAryHeap<4> pqF, pqB;
+
+    auto runBoth = [&](int s) {
+        #pragma omp parallel sections num_threads(2)
+        {
+            #pragma omp section
+            dijkstraFrom(g, s, fwd, pqF);
+            #pragma omp section
+            dijkstraFrom(rev, s, bwd, pqB);
+        }
+    };
+    auto farthest = [&]() {
+        int best = 0;
+        for (int v = 1; v < g.n; v++) if (score[v] > score[best]) best = v;
+        return best;
+    };
+    auto addScores = [&]() {
+        for (int v = 0; v < g.n; v++) {
+            ll d = (ll)fwd[v] + bwd[v];  // two INFs still fit in a ll
+            score[v] = std::min(score[v], d);
+        }
+    };
+
+    if (t.k > 0) {
+        runBoth(std::min(std::max(seed, 0), g.n - 1));
+        addScores();
+    }
+    for (int i = 0; i < t.k; i++) {
+        int L = farthest();
+        if (i == 0) std::fill(score.begin(), score.end(), std::numeric_limits<ll>::max());
+        t.landmarks.push_back(L);
+        runBoth(L);
+        addScores();
+        score[L] = -1;  // never pick it twice
+        for (int v = 0; v < g.n; v++) {
+            t.from[(size_t)v * t.k + i] = fwd[v];
+            t.to[(size_t)v * t.k + i] = bwd[v];
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    t.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return t;
+}
+
+void LandmarkTable::save(const string& filename, const Graph& g) const {
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("[ERR] Cannot open file: " + filename);
+    }
+
+    LandmarkFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+    h.version = LANDMARK_FORMAT_VERSION;
+    h.k = k;
+    h.n = n;
+    h.m = g.m;
+    h.graphChecksum = graphChecksum(g);
+
+    file.write((const char*)&h, sizeof(h));
+    file.write((const char*)landmarks.data(), landmarks.size() * sizeof(int));
+    file.write((const char*)from.data(), from.size() * sizeof(Weight));
+    file.write((const char*)to.data(), to.size() * sizeof(Weight));
+    if (!file) {
+        throw runtime_error("[ERR] Failed writing: " + filename);
+    }
+}
+
+LandmarkTable LandmarkTable::load(const string& filename, const Graph& g) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("[ERR] Cannot open file: " + filename);
+    }
+
+    LandmarkFileHeader h;
+    file.read((char*)&h, sizeof(h));
+    if (!file || memcmp(h.magic, LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC)) != 0) {
+        throw runtime_error("[ERR] Not a landmark file: " + filename);
+    }
+    if (h.version != LANDMARK_FORMAT_VERSION) {
+        throw runtime_error("[ERR] Unsupported landmark file version " + to_string(h.version) + ": " + filename);
+    }
+    if (h.n != (uint64_t)g.n || h.m != (uint64_t)g.m || h.k > h.n || h.graphChecksum != graphChecksum(g)) {
+        throw runtime_error("[ERR] Landmark file was built for a different graph: " + filename);
+    }
+
+    LandmarkTable t;
+    t.n = g.n;
+    t.k = (int)h.k;
+    t.landmarks.resize(t.k);
+    t.from.resize((size_t)t.n * t.k);
+    t.to.resize((size_t)t.n * t.k);
+    file.read((char*)t.landmarks.data(), t.landmarks.size() * sizeof(int));
+    file.read((char*)t.from.data(), t.from.size() * sizeof(Weight));
+    file.read((char*)t.to.data(), t.to.size() * sizeof(Weight));
+    if (!file) {
+        throw runtime_error("[ERR] Landmark file is truncated: " + filename);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    t.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return t;
+}
+
+Weight LandmarkTable::lowerBound(int v, int t) const {
+    const Weight* fv = &from[(size_t)v * k];
+    const Weight* ft = &from[(size_t)t * k];
+    const Weight* tv = &to[(size_t)v * k];
+    const Weight* tt = &to[(size_t)t * k];
+
+    Weight best = 0;
+    for (int i = 0; i < k; i++) {
+        // d(L,t) <= d(L,v) + d(v,t)
+        if (fv[i] != INF) {
+            if (ft[i] == INF) return INF;  // L reaches v but not t
+            best = std::max(best, ft[i] - fv[i]);
+        }
+        // d(v,L) <= d(v,t) + d(t,L)
+        if (tt[i] != INF) {
+            if (tv[i] == INF) return INF;  // t reaches L but v doesn't
+            best = std::max(best, tv[i] - tt[i]);
+        }
+    }
+    return best;
+}
+
+LandmarkTable loadOrBuildLandmarks(const Graph& g, const Graph& rev, const string& graphFile, int k) {
+    string path = landmarkPath(graphFile);
+    if (ifstream(path).good()) {
+        try {
+            LandmarkTable t = LandmarkTable::load(path, g);
+            if (t.k == std::min(k, g.n)) return t;
+            std::cerr << "[INFO] " << path << " has " << t.k << " landmarks, rebuilding with " << k << "\n";
+        } catch (const exception& e) {
+            std::cerr << e.what() << ", rebuilding\n";
+        }
+    }
+
+    LandmarkTable t = LandmarkTable::build(g, rev, k);
+    try {
+        t.save(path, g);
+    } catch (const exception& e) {
+        std::cerr << e.what() << " (landmarks not saved)\n";
+    }
+    return t;
+}
+
+PointToPointEngine::PointToPointEngine(const Graph& g, const Graph& rev, shared_ptr<const LandmarkTable> landmarks)
+    : g(g), rev(rev), landmarks(std::move(landmarks)) {
+    if (rev.n != g.n || rev.m != g.m) {
+        throw runtime_error("[ERR] PointToPointEngine: rev is not the transpose of g");
+    }
+    requireNonNegative(g);
+    distF.assign(g.n, INF);
+    distB.assign(g.n, INF);
+    heapF.reset(g.n);
+    heapB.reset(g.n);
+}
+
+void PointToPointEngine::setLandmarks(shared_ptr<const LandmarkTable> table) {
+    if (table && table->n != g.n) {
+        throw runtime_error("[ERR] Landmark table is for a graph with " + to_string(table->n) + " vertices");
+    }
+    landmarks = std::move(table);
+}
+
+void PointToPointEngine::resetState() {
+    for (int v : touchedF) distF[v] = INF;
+    for (int v : touchedB) distB[v] = INF;
+    touchedF.clear();
+    touchedB.clear();
+    heapF.clear();
+    heapB.clear();
+}
+
+QueryResult PointToPointEngine::dijkstra(int s, int t) {
+    auto start = std::chrono::high_resolution_clock::now();
+    resetState();
+
+    ll settled = 0;
+    distF[s] = 0;
+    touchedF.push_back(s);
+    heapF.push(s, 0);
+    while (!heapF.empty()) {
+        auto [du, u] = heapF.pop();
+        settled++;
+        if (u == t) break;
+        for (auto e : g.neighbors(u)) {
+            Weight nd = du + e.weight;
+            if (nd < distF[e.to]) {
+                if (distF[e.to] == INF) touchedF.push_back(e.to);
+                distF[e.to] = nd;
+                heapF.push(e.to, nd);
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    return {distF[t], elapsed, settled, "Dijkstra (early exit)"};
+}
+
+QueryResult PointToPointEngine::bidirectional(int s, int t) {
+    auto start = std::chrono::high_resolution_clock::now();
+    resetState();
+
+    ll settled = 0;
+    distF[s] = 0;
+    distB[t] = 0;
+    touchedF.push_back(s);
+    touchedB.push_back(t);
+    heapF.push(s, 0);
+    heapB.push(t, 0);
+    Weight best = s == t ? 0 : INF;  // shortest s-t path seen so far
+
+    // one step of either search: settle the top vertex and relax its edges,
+    // checking every reached vertex against the other side's labels
+    auto step = [&](const Graph& graph, DAryHeap<4>& heap, vector<Weight>& dist,
+                    vector<int>& touched, const vector<Weight>& other) {
+        auto [du, u] = heap.pop();
+        settled++;
+        for (auto e : graph.neighbors(u)) {
+            Weight nd = du + e.weight;
+            if (nd < dist[e.to]) {
+                if (dist[e.to] == INF) touched.push_back(e.to);
+                dist[e.to] = nd;
+                heap.push(e.to, nd);
+            }
+            if (other[e.to] != INF) best = std::min(best, nd + other[e.to]);
+        }
+    };
+
+    // a path shorter than best would have to go through two unsettled
+    // vertices, one per side, so it's at least topF + topB
+    while (!heapF.empty() && !heapB.empty()) {
+        Weight topF = heapF.topKey(), topB = heapB.topKey();
+        if (topF + topB >= best) break;
+        if (topF <= topB) step(g, heapF, distF, touchedF, distB);
+        else step(rev, heapB, distB, touchedB, distF);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    return {best, elapsed, settled, "Bidirectional Dijkstra"};
+}
+
+QueryResult PointToPointEngine::altAStar(int s, int t) {
+    if (!landmarks) {
+        throw runtime_error("[ERR] ALT query without a landmark table");
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    resetState();
+
+    const LandmarkTable& lm = *landmarks;
+    ll settled = 0;
+    distF[s] = 0;
+    touchedF.push_back(s);
+    Weight hs = lm.lowerBound(s, t);
+    if (hs != INF) heapF.push(s, hs);
+
+    // the ALT bound is consistent, so keys are dist + h and every vertex is
+    // settled at most once, like plain Dijkstra
+    while (!heapF.empty()) {
+        int u = heapF.pop().second;
+        settled++;
+        if (u == t) break;
+        Weight du = distF[u];
+        for (auto e : g.neighbors(u)) {
+            Weight nd = du + e.weight;
+            if (nd < distF[e.to]) {
+                Weight h = lm.lowerBound(e.to, t);
+                if (h == INF) continue;  // can't reach t from there
+                if (distF[e.to] == INF) touchedF.push_back(e.to);
+                distF[e.to] = nd;
+                heapF.push(e.to, nd + h);
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+    return {distF[t], elapsed, settled, "ALT A* (" + to_string(lm.k) + " landmarks)"};
+}
@@ -0,0 +1,108 @@
+#include "../inc/paths.h"
+#include "../inc/relax.h"
+#include <omp.h>
+#include <stdexcept>
+
+static const int UNKNOWN = -2;
+static const int ON_STACK = -3;
+static const int NO_PATH = -1;
+
+// depth[v] = edges from the source down to v, NO_PATH if following parents
+// from v runs out before reaching it. Climbs only until a vertex whose depth
+// is already known, then fills in the way back down
+static void climb(const vector<int>& parents, int v, vector<int>& depth, vector<int>& stack) {
+    const int n = (int)parents.size();
+    int x = v;
+    while (depth[x] == UNKNOWN) {
+        depth[x] = ON_STACK;
+        stack.push_back(x);
+        x = parents[x];
+        if (x == -1) break;
+        if (x < 0 || x >= n) {
+            throw runtime_error("[ERR] Parent of vertex " + to_string(stack.back()) + " out of range");
+        }
+        if (depth[x] == ON_STACK) throw runtime_error("[ERR] Parent cycle through vertex " + to_string(x));
+    }
+    int d = x == -1 ? NO_PATH : depth[x];
+    while (!stack.empty()) {
+        depth[stack.back()] = d == NO_PATH ? NO_PATH : ++d;
+        stack.pop_back();
+    }
+}
+
+static vector<int> depthsFrom(const vector<int>& parents, int source) {
+    if (source < 0 || source >= (int)parents.size()) {
+        throw runtime_error("[ERR] Source " + to_string(source) + " out of range for the parents array");
+    }
+    vector<int> depth(parents.size(), UNKNOWN);
+    depth[source] = 0;
+    return depth;
+}
+
+PathSet extractPaths(const vector<int>& parents, int source, const vector<int>& targets, int threads) {
+    vector<int> depth = depthsFrom(parents, source);
+    vector<int> stack;
+    PathSet out;
+    out.offsets.assign(targets.size() + 1, 0);
+    for (size_t i = 0; i < targets.size(); i++) {
+        int t = targets[i];
+        if (t < 0 || t >= (int)parents.size()) throw runtime_error("[ERR] Target " + to_string(t) + " out of range");
+        climb(parents, t, depth, stack);
+        out.offsets[i + 1] = out.offsets[i] + (depth[t] == NO_PATH ? 0 : depth[t] + 1);
+    }
+
+    out.vertices.resize(out.offsets.back());
+    #pragma omp parallel for schedule(dynamic, 64) num_threads(threads)
+    for (size_t i = 0; i < targets.size(); i++) {
+        int x = targets[i];
+        for (ll k = out.offsets[i + 1] - 1; k >= out.offsets[i]; k--) {
+            out.vertices[k] = x;
+            x = parents[x];
+        }
+    }
+    return out;
+}
+
+string validateParents(const Graph& g, int source, const vector<Weight>& dist, const vector<int>& parents) {
+    if ((int)parents.size() != g.n || (int)dist.size() != g.n) {
+        return "parents has " + to_string(parents.size()) + " entries for " + to_string(g.n) + " vertices";
+    }
+    auto hasPath = [&](int v) { return dist[v] != INF && dist[v] != NEG_INF; };
+
+    // tight[v]: parent[v] -> v is an edge that gives exactly dist[v]. One
+    // pass over the edges, a hub with many children isn't rescanned per child
+    vector<char> tight(g.n, 0);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int u = 0; u < g.n; u++) {
+        if (!hasPath(u)) continue;
+        for (const auto& edge : g.neighbors(u)) {
+            if (parents[edge.to] == u && dist[u] + edge.weight == dist[edge.to]) atomicStore(&tight[edge.to], (char)1);
+        }
+    }
+
+    for (int v = 0; v < g.n; v++) {
+        bool root = v == source || !hasPath(v);
+        if (root && parents[v] != -1) {
+            return "vertex " + to_string(v) + " should have no parent but has " + to_string(parents[v]);
+        }
+        if (!root && !tight[v]) {
+            return "vertex " + to_string(v) + " (dist " + to_string(dist[v]) + "): parent " +
+                   to_string(parents[v]) + " isn't a shortest-path predecessor";
+        }
+    }
+
+    // zero-weight edges are tight in both directions, so the per-edge check
+    // alone doesn't rule out a cycle
+    try {
+        vector<int> depth = depthsFrom(parents, source);
+        vector<int> stack;
+        for (int v = 0; v < g.n; v++) {
+            if (!hasPath(v)) continue;
+            climb(parents, v, depth, stack);
+            if (depth[v] == NO_PATH) return "vertex " + to_string(v) + " doesn't lead back to the source";
+        }
+    } catch (const exception& e) {
+        return e.what();
+    }
+    return "";
+}
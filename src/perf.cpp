@@ -0,0 +1,154 @@
+#include "../inc/perf.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+    const char* name;
+};
+
+static const uint64_t CACHE_READ_MISS = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+// same order as the fields of HardwareCounters
+static const EventSpec EVENTS[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | CACHE_READ_MISS, "llc-misses"},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | CACHE_READ_MISS, "dtlb-misses"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch-misses"},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task-clock"},
+};
+static const int NUM_EVENTS = sizeof(EVENTS) / sizeof(EVENTS[0]);
+
+static int openEvent(const EventSpec& spec, pid_t tid) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;  // allowed at perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+}
+
+static std::vector<pid_t> threadsOfProcess() {
+    std::vector<pid_t> tids;
+    if (DIR* dir = opendir("/proc/self/task")) {
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') tids.push_back((pid_t)atoi(entry->d_name));
+        }
+        closedir(dir);
+    }
+    if (tids.empty()) tids.push_back((pid_t)syscall(SYS_gettid));
+    return tids;
+}
+
+void PerfSession::closeAll() {
+    for (const auto& e : events) close(e.fd);
+    events.clear();
+}
+
+void PerfSession::start() {
+    closeAll();
+    opened = 0;
+    std::vector<pid_t> tids = threadsOfProcess();
+
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (refused & (1u << i)) continue;
+        size_t first = events.size();
+        for (pid_t tid : tids) {
+            int fd = openEvent(EVENTS[i], tid);
+            if (fd >= 0) {
+                events.push_back({i, fd});
+                opened |= 1u << i;
+            } else if (errno != ESRCH) {  // ESRCH: that thread just exited
+                lastErrno = errno;
+                refused |= 1u << i;
+                // a sum over only some of the threads isn't the process
+                // total, drop what this event got open
+                for (size_t k = first; k < events.size(); k++) close(events[k].fd);
+                events.resize(first);
+                opened &= ~(1u << i);
+                break;
+            }
+        }
+    }
+
+    for (const auto& e : events) {
+        ioctl(e.fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(e.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+HardwareCounters PerfSession::stop() {
+    for (const auto& e : events) ioctl(e.fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    double total[NUM_EVENTS] = {0};
+    for (const auto& e : events) {
+        uint64_t values[3];  // value, time enabled, time running
+        if (read(e.fd, values, sizeof(values)) != (ssize_t)sizeof(values)) continue;
+        double v = (double)values[0];
+        // the PMU was shared with other events part of the time, scale up
+        if (values[2] > 0 && values[2] < values[1]) v *= (double)values[1] / values[2];
+        total[e.event] += v;
+    }
+    closeAll();
+
+    HardwareCounters hw;
+    ll* fields[] = {&hw.cycles, &hw.instructions, &hw.llc_misses, &hw.dtlb_misses, &hw.branch_misses};
+    for (int i = 0; i < 5; i++) {
+        if (opened & (1u << i)) *fields[i] = (ll)total[i];
+    }
+    if (opened & (1u << 5)) hw.task_clock_ms = total[5] / 1e6;
+    return hw;
+}
+
+string PerfSession::describe() const {
+    string out;
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (opened & (1u << i)) out += (out.empty() ? "" : " ") + string(EVENTS[i].name);
+    }
+    string missing;
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (refused & (1u << i)) missing += (missing.empty() ? "" : " ") + string(EVENTS[i].name);
+    }
+    if (missing.empty()) return out.empty() ? "none" : out;
+
+    string reason = strerror(lastErrno);
+    std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+    int level;
+    if (paranoid >> level) reason += ", perf_event_paranoid=" + to_string(level);
+    return (out.empty() ? "none" : out) + " (unavailable: " + missing + " - " + reason + ")";
+}
+
+Result PerfCountedSolver::solve(const Graph& g, int source) {
+    session->start();
+    Result r = inner->solve(g, source);
+    r.hw = session->stop();
+    return r;
+}
+
+vector<Result> PerfCountedSolver::solveBatch(const Graph& g, const vector<int>& sources) {
+    session->start();
+    vector<Result> out = inner->solveBatch(g, sources);
+    HardwareCounters total = session->stop();
+
+    ll count = std::max<ll>(1, (ll)out.size());
+    HardwareCounters each = total;
+    for (ll* f : {&each.cycles, &each.instructions, &each.llc_misses, &each.dtlb_misses, &each.branch_misses}) {
+        if (*f >= 0) *f /= count;
+    }
+    if (each.task_clock_ms >= 0) each.task_clock_ms /= count;
+    for (auto& r : out) r.hw = each;
+    return out;
+}
@@ -0,0 +1,156 @@
+#include "../inc/profile.h"
+#include <omp.h>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+
+// below this many edges the serial engines win, thread start-up and the
+// extra passes of the parallel ones don't pay off
+static const ll PARALLEL_MIN_EDGES = 1 << 20;
+// parallel engines get at least this many edges per thread
+static const ll EDGES_PER_THREAD = 1 << 18;
+// max degree / average degree above this counts as a skewed (power-law) graph
+static const double SKEWED = 32;
+// delta-stepping's buckets thin out when max / min weight gets this large
+static const Weight WIDE_RANGE = 1 << 16;
+
+// farthest reached vertex and its hop distance, -1 if only the source was reached
+static std::pair<int, int> farthest(const std::vector<Weight>& hops) {
+    int far = -1, ecc = 0;
+    for (int v = 0; v < (int)hops.size(); v++) {
+        if (hops[v] != INF && hops[v] > ecc) {
+            ecc = hops[v];
+            far = v;
+        }
+    }
+    return {far, ecc};
+}
+
+GraphProfile GraphProfile::of(const Graph& g, int threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    GraphProfile p;
+    p.n = g.n;
+    p.m = g.m;
+    if (g.n == 0) return p;
+
+    const ll* off = g.offsets();
+    const Weight* w = g.edgeWeights();
+    Weight lo = INF, hi = -INF;
+    ll maxDegree = 0;
+    int hub = 0;
+    bool allOnes = true;
+
+    #pragma omp parallel for schedule(static) num_threads(threads) \
+        reduction(min:lo) reduction(max:hi) reduction(&&:allOnes)
+    for (ll e = 0; e < g.m; e++) {
+        lo = std::min(lo, w[e]);
+        hi = std::max(hi, w[e]);
+        allOnes = allOnes && w[e] == 1;
+    }
+    #pragma omp parallel for schedule(static) num_threads(threads) reduction(max:maxDegree)
+    for (int u = 0; u < g.n; u++) {
+        maxDegree = std::max(maxDegree, off[u + 1] - off[u]);
+    }
+    for (int u = 0; u < g.n; u++) {
+        if (off[u + 1] - off[u] == maxDegree) {
+            hub = u;
+            break;
+        }
+    }
+
+    p.minWeight = g.m ? lo : 0;
+    p.maxWeight = g.m ? hi : 0;
+    p.unitWeights = g.m > 0 && allOnes;
+    p.negativeWeights = g.m > 0 && lo < 0;
+    p.avgDegree = (double)g.m / g.n;
+    p.maxDegree = maxDegree;
+
+    // double sweep: BFS from the biggest hub, then again from the farthest
+    // vertex it found. Exact on trees, a decent lower bound elsewhere
+    if (g.m > 0) {
+        BFSParallel bfs(threads);
+        auto [far, ecc] = farthest(bfs.solve(g, hub).distances);
+        p.diameter = ecc;
+        if (far >= 0) p.diameter = std::max(p.diameter, farthest(bfs.solve(g, far).distances).second);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    p.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return p;
+}
+
+std::string GraphProfile::describe() const {
+    std::ostringstream out;
+    out << n << " vertices, " << m << " edges, weights [" << minWeight << ", " << maxWeight << "]";
+    if (unitWeights) out << " (unit)";
+    if (negativeWeights) out << " (negative)";
+    out << ", degree avg " << std::fixed << std::setprecision(1) << avgDegree << " max " << maxDegree
+        << " (skew " << degreeSkew() << "x), diameter ~" << diameter << " hops";
+    return out.str();
+}
+
+AutoDecision chooseSolver(const GraphProfile& p, int threads) {
+    bool big = p.m >= PARALLEL_MIN_EDGES && threads > 1;
+    int useThreads = (int)std::max<ll>(1, std::min<ll>(threads, p.m / EDGES_PER_THREAD));
+    // small world: hop diameter well under sqrt(n), unlike grids and road networks
+    bool shallow = (double)p.diameter * p.diameter < p.n;
+    bool skewed = p.degreeSkew() > SKEWED;
+
+    if (p.m == 0) return {"bfs", 1, "no edges"};
+    if (p.negativeWeights) {
+        // subtree disassembly is about as fast as SPFA and the only engine
+        // here that stops on a negative cycle
+        return {"bellman-ford-tarjan", useThreads,
+                "negative weights: Bellman-Ford with subtree disassembly, negative cycles marked -INF"};
+    }
+    if (p.unitWeights) {
+        if (big && (shallow || skewed)) {
+            return {"bfs-omp", useThreads, "unit weights, large low-diameter graph: direction-optimizing BFS"};
+        }
+        return {"bfs", 1, "unit weights: BFS"};
+    }
+    if (big && shallow && p.maxWeight / std::max<Weight>(p.minWeight, 1) < WIDE_RANGE) {
+        return {"delta-stepping", useThreads, "non-negative weights, large low-diameter graph: delta-stepping"};
+    }
+    std::string why = !big ? "small graph or a single core" : !shallow ? "high diameter" : "wide weight range";
+    return {"dijkstra-radix", 1, "non-negative weights, " + why + ": radix-heap Dijkstra"};
+}
+
+SSSPSolver& AutoSolver::engineFor(const Graph& g) {
+    if (engine && g.is(profiled)) return *engine;
+
+    profile = GraphProfile::of(g, num_threads);
+    // more threads than cores only adds contention
+    decision = chooseSolver(profile, std::min(num_threads, omp_get_num_procs()));
+    engine = findSolver(decision.key).make(decision.threads);
+    engine->setTrackParents(parentsOn);
+    profiled = g.identity();
+
+    if (log) {
+        *log << "[INFO] auto: " << profile.describe() << ", profiled in " << std::fixed
+             << std::setprecision(3) << profile.time_ms << " ms\n"
+             << "[INFO] auto: -> " << decision.key << " (" << decision.threads << " thread"
+             << (decision.threads == 1 ? "" : "s") << "), " << decision.reason << "\n";
+    }
+    return *engine;
+}
+
+// results say which engine produced them
+Result AutoSolver::solve(const Graph& g, int source) {
+    Result r = engineFor(g).solve(g, source);
+    r.algorithm_name = getName();
+    return r;
+}
+
+std::vector<Result> AutoSolver::solveBatch(const Graph& g, const std::vector<int>& sources) {
+    std::vector<Result> out = engineFor(g).solveBatch(g, sources);
+    for (auto& r : out) r.algorithm_name = getName();
+    return out;
+}
+
+ResultView AutoSolver::solveInto(const Graph& g, int source, SolverWorkspace& ws) {
+    ResultView r = engineFor(g).solveInto(g, source, ws);
+    r.algorithm_name = getName();
+    return r;
+}
@@ -0,0 +1,221 @@
+#include "../inc/reorder.h"
+#include "../inc/parallel.h"
+#include <omp.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <chrono>
+
+Ordering parseOrdering(const string& name) {
+    if (name == "none") return Ordering::None;
+    if (name == "degree") return Ordering::DegreeDescending;
+    if (name == "rcm") return Ordering::RCM;
+    if (name == "bfs") return Ordering::BFS;
+    if (name == "dfs") return Ordering::DFS;
+    if (name == "hub") return Ordering::HubCluster;
+    throw runtime_error("[ERR] Unknown ordering: " + name + " (none, degree, rcm, bfs, dfs, hub)");
+}
+
+string orderingName(Ordering kind) {
+    switch (kind) {
+        case Ordering::None: return "none";
+        case Ordering::DegreeDescending: return "degree";
+        case Ordering::RCM: return "rcm";
+        case Ordering::BFS: return "bfs";
+        case Ordering::DFS: return "dfs";
+        case Ordering::HubCluster: return "hub";
+    }
+    return "?";
+}
+
+// all of these return oldId order: position i holds the original vertex that
+// becomes i
+
+static vector<int> degreeOrder(const Graph& g) {
+    vector<int> order(g.n);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return g.degree(a) > g.degree(b); });
+    return order;
+}
+
+// hub clustering (Balaji & Lucia): hubs packed together at the front, both
+// groups keep their original relative order
+static vector<int> hubOrder(const Graph& g) {
+    double avg = g.n > 0 ? (double)g.m / g.n : 0;
+    vector<int> order;
+    order.reserve(g.n);
+    for (int v = 0; v < g.n; v++) if (g.degree(v) > avg) order.push_back(v);
+    for (int v = 0; v < g.n; v++) if (g.degree(v) <= avg) order.push_back(v);
+    return order;
+}
+
+// BFS from root, then from every vertex still unseen in id order. With
+// byDegree the neighbours are queued in increasing degree (Cuthill-McKee)
+static vector<int> bfsOrder(const Graph& g, int root, bool byDegree) {
+    vector<int> order;
+    order.reserve(g.n);
+    vector<char> seen(g.n, 0);
+    vector<int> nbrs;
+
+    auto visitFrom = [&](int s) {
+        size_t head = order.size();
+        seen[s] = 1;
+        order.push_back(s);
+        while (head < order.size()) {
+            int u = order[head++];
+            nbrs.clear();
+            for (auto e : g.neighbors(u)) {
+                if (!seen[e.to]) {
+                    seen[e.to] = 1;
+                    nbrs.push_back(e.to);
+                }
+            }
+            if (byDegree) {
+                stable_sort(nbrs.begin(), nbrs.end(), [&](int a, int b) { return g.degree(a) < g.degree(b); });
+            }
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    };
+
+    if (g.n > 0) visitFrom(root);
+    for (int v = 0; v < g.n; v++) if (!seen[v]) visitFrom(v);
+    return order;
+}
+
+// iterative DFS preorder, neighbours taken in adjacency order
+static vector<int> dfsOrder(const Graph& g, int root) {
+    vector<int> order;
+    order.reserve(g.n);
+    vector<char> seen(g.n, 0);
+    vector<pair<int, ll>> stack;  // (vertex, next edge index)
+    const ll* off = g.offsets();
+    const int* to = g.targets();
+
+    auto visitFrom = [&](int s) {
+        seen[s] = 1;
+        order.push_back(s);
+        stack.push_back({s, off[s]});
+        while (!stack.empty()) {
+            auto& [u, i] = stack.back();
+            if (i == off[u + 1]) {
+                stack.pop_back();
+                continue;
+            }
+            int v = to[i++];
+            if (!seen[v]) {
+                seen[v] = 1;
+                order.push_back(v);
+                stack.push_back({v, off[v]});
+            }
+        }
+    };
+
+    if (g.n > 0) visitFrom(root);
+    for (int v = 0; v < g.n; v++) if (!seen[v]) visitFrom(v);
+    return order;
+}
+
+Graph permuteGraph(const Graph& g, const vector<int>& newId, const vector<int>& oldId) {
+    vector<ll> rowPtr(g.n + 1, 0);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < g.n; i++) rowPtr[i] = g.degree(oldId[i]);
+    ll m = parallelExclusiveScan(rowPtr);
+
+    vector<int> colIdx(m);
+    vector<Weight> weights(m);
+    vector<pair<int, Weight>> row;
+
+    #pragma omp parallel for schedule(dynamic, 1024) private(row)
+    for (int i = 0; i < g.n; i++) {
+        row.clear();
+        for (auto e : g.neighbors(oldId[i])) row.push_back({newId[e.to], e.weight});
+        sort(row.begin(), row.end());
+        ll base = rowPtr[i];
+        for (size_t k = 0; k < row.size(); k++) {
+            colIdx[base + k] = row[k].first;
+            weights[base + k] = row[k].second;
+        }
+    }
+
+    return Graph(g.n, std::move(rowPtr), std::move(colIdx), std::move(weights));
+}
+
+Reordering Reordering::compute(const Graph& g, Ordering kind, int root) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Reordering r;
+    r.kind = kind;
+    switch (kind) {
+        case Ordering::None:
+            r.oldId.resize(g.n);
+            iota(r.oldId.begin(), r.oldId.end(), 0);
+            break;
+        case Ordering::DegreeDescending: r.oldId = degreeOrder(g); break;
+        case Ordering::HubCluster: r.oldId = hubOrder(g); break;
+        case Ordering::BFS: r.oldId = bfsOrder(g, root, false); break;
+        case Ordering::RCM:
+            r.oldId = bfsOrder(g, root, true);
+            reverse(r.oldId.begin(), r.oldId.end());
+            break;
+        case Ordering::DFS: r.oldId = dfsOrder(g, root); break;
+    }
+
+    r.newId.resize(g.n);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < g.n; i++) r.newId[r.oldId[i]] = i;
+
+    r.graph = kind == Ordering::None ? g : permuteGraph(g, r.newId, r.oldId);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    r.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return r;
+}
+
+vector<Weight> Reordering::toOriginal(const vector<Weight>& dist) const {
+    vector<Weight> out(dist.size());
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < (int)dist.size(); v++) out[v] = dist[newId[v]];
+    return out;
+}
+
+vector<int> Reordering::parentsToOriginal(const vector<int>& parent) const {
+    vector<int> out(parent.size());
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < (int)parent.size(); v++) {
+        int p = parent[newId[v]];
+        out[v] = p < 0 ? -1 : oldId[p];
+    }
+    return out;
+}
+
+static void checkSameGraph(const Graph& g, const Reordering& order) {
+    if (g.n != order.graph.n || g.m != order.graph.m) {
+        throw runtime_error("[ERR] ReorderedSolver used on a different graph than it was built for");
+    }
+}
+
+Result ReorderedSolver::solve(const Graph& g, int source) {
+    checkSameGraph(g, *order);
+    Result r = inner->solve(order->graph, order->newId[source]);
+    r.distances = order->toOriginal(r.distances);
+    if (!r.parents.empty()) r.parents = order->parentsToOriginal(r.parents);
+    r.implementation_type = getType();
+    r.reorder_ms = order->time_ms;
+    return r;
+}
+
+vector<Result> ReorderedSolver::solveBatch(const Graph& g, const vector<int>& sources) {
+    checkSameGraph(g, *order);
+    vector<int> mapped(sources.size());
+    for (size_t i = 0; i < sources.size(); i++) mapped[i] = order->newId[sources[i]];
+
+    vector<Result> out = inner->solveBatch(order->graph, mapped);
+    for (auto& r : out) {
+        r.distances = order->toOriginal(r.distances);
+        if (!r.parents.empty()) r.parents = order->parentsToOriginal(r.parents);
+        r.implementation_type = getType();
+        r.reorder_ms = order->time_ms;
+    }
+    return out;
+}
@@ -0,0 +1,350 @@
+#include "../inc/server.h"
+#include <thread>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool readFull(int fd, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t got = read(fd, p, len);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got;
+        len -= got;
+    }
+    return true;
+}
+
+static bool writeFull(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t put = write(fd, p, len);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        p += put;
+        len -= put;
+    }
+    return true;
+}
+
+template <typename T>
+static void append(std::vector<char>& out, const T& value) {
+    const char* p = (const char*)&value;
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+// reads a T at pos, false if the payload is too short
+template <typename T>
+static bool take(const std::vector<char>& in, size_t& pos, T& value) {
+    if (pos + sizeof(T) > in.size()) return false;
+    memcpy(&value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+// OP_SSSP response body: u32 n, Weight x n
+static std::vector<char> distanceBody(const Weight* dist, int n) {
+    uint32_t count = (uint32_t)n;
+    std::vector<char> body(4 + (size_t)n * sizeof(Weight));
+    memcpy(body.data(), &count, 4);
+    if (n > 0) memcpy(body.data() + 4, dist, (size_t)n * sizeof(Weight));
+    return body;
+}
+
+QueryServer::Connection::~Connection() {
+    if (ownsFd) close(inFd);
+}
+
+QueryServer::QueryServer(const Graph& g, SolverFactory makeSolver, shared_ptr<const LandmarkTable> landmarks,
+                         ServerConfig config)
+    : g(g), makeSolver(std::move(makeSolver)), landmarks(std::move(landmarks)), config(config) {
+    const Weight* w = g.edgeWeights();
+    p2pReady = std::none_of(w, w + g.m, [](Weight x) { return x < 0; });
+    if (p2pReady) rev = g.transpose();
+    this->config.workers = std::max(1, config.workers);
+    this->config.maxBatch = std::max(1, config.maxBatch);
+}
+
+void QueryServer::respond(const Request& req, uint8_t status, const std::vector<char>& body) {
+    std::vector<char> frame;
+    frame.reserve(9 + body.size());
+    append(frame, (uint32_t)(4 + 1 + body.size()));
+    append(frame, req.id);
+    append(frame, status);
+    frame.insert(frame.end(), body.begin(), body.end());
+
+    {
+        std::lock_guard<std::mutex> lock(req.conn->writeMu);
+        writeFull(req.conn->outFd, frame.data(), frame.size());  // a gone client just loses the answer
+    }
+    if (status == STATUS_OK) recordLatency(req);
+}
+
+void QueryServer::fail(const Request& req, const string& message) {
+    respond(req, STATUS_ERROR, std::vector<char>(message.begin(), message.end()));
+}
+
+void QueryServer::recordLatency(const Request& req) {
+    if (req.op != OP_SSSP && req.op != OP_P2P) return;
+    int kind = req.op == OP_SSSP ? 0 : 1;
+    auto now = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(now - req.received).count();
+
+    std::lock_guard<std::mutex> lock(latencyMu);
+    auto& ring = latencyUs[kind];
+    if (ring.size() < LATENCY_WINDOW) ring.push_back(us);
+    else ring[latencyCount[kind] % LATENCY_WINDOW] = us;
+    latencyCount[kind]++;
+}
+
+LatencySummary QueryServer::latency(ServerOp op) const {
+    std::vector<double> samples;
+    LatencySummary s = {0, 0, 0, 0, 0};
+    {
+        std::lock_guard<std::mutex> lock(latencyMu);
+        if (op != OP_SSSP && op != OP_P2P) return s;
+        int kind = op == OP_SSSP ? 0 : 1;
+        samples = latencyUs[kind];
+        s.count = latencyCount[kind];
+    }
+    if (samples.empty()) return s;
+
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) { return samples[(size_t)(p * (samples.size() - 1))]; };
+    s.p50 = pct(0.50);
+    s.p90 = pct(0.90);
+    s.p99 = pct(0.99);
+    s.max = samples.back();
+    return s;
+}
+
+string QueryServer::latencyReport() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    for (ServerOp op : {OP_SSSP, OP_P2P}) {
+        LatencySummary s = latency(op);
+        out << (op == OP_SSSP ? "SSSP" : "P2P ") << "  count " << s.count << "  p50 " << s.p50
+            << " us  p90 " << s.p90 << " us  p99 " << s.p99 << " us  max " << s.max << " us\n";
+    }
+    return out.str();
+}
+
+void QueryServer::readLoop(shared_ptr<Connection> conn) {
+    while (true) {
+        uint32_t length;
+        if (!readFull(conn->inFd, &length, sizeof(length))) break;
+        if (length < 5 || length > MAX_FRAME_BYTES) break;  // not our protocol, drop the client
+
+        std::vector<char> frame(length);
+        if (!readFull(conn->inFd, frame.data(), length)) break;
+
+        Request req;
+        req.conn = conn;
+        memcpy(&req.id, frame.data(), 4);
+        req.op = (uint8_t)frame[4];
+        req.payload.assign(frame.begin() + 5, frame.end());
+        req.received = std::chrono::steady_clock::now();
+
+        if (req.op == OP_STATS) {
+            std::vector<char> body;
+            append(body, latency(OP_SSSP));
+            append(body, latency(OP_P2P));
+            respond(req, STATUS_OK, body);
+            continue;
+        }
+        if (req.op == OP_SHUTDOWN) {
+            {
+                std::lock_guard<std::mutex> lock(queueMu);
+                shutdownRequested = true;
+                shutdownRequest = std::move(req);
+            }
+            // wakes accept() in socket mode
+            std::lock_guard<std::mutex> lock(connMu);
+            if (listenFd >= 0) ::shutdown(listenFd, SHUT_RDWR);
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMu);
+            queue.push_back(std::move(req));
+        }
+        queueCv.notify_one();
+    }
+}
+
+void QueryServer::workerLoop() {
+    unique_ptr<SSSPSolver> solver = makeSolver();
+    unique_ptr<PointToPointEngine> engine;
+    if (p2pReady) engine = std::make_unique<PointToPointEngine>(g, rev, landmarks);
+
+    SolverWorkspace ws;
+    std::vector<Request> batch;
+    std::vector<const Request*> ssspReqs;
+    std::vector<int> sources;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMu);
+            queueCv.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;  // stopping and drained
+            while (!queue.empty() && (int)batch.size() < config.maxBatch) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+
+        for (const Request& req : batch) {
+            size_t pos = 0;
+            if (req.op == OP_SSSP) {
+                int32_t source;
+                if (!take(req.payload, pos, source)) fail(req, "SSSP request needs a source");
+                else if (source < 0 || source >= g.n) fail(req, "source out of range");
+                else {
+                    ssspReqs.push_back(&req);
+                    sources.push_back(source);
+                }
+            } else if (req.op == OP_P2P) {
+                int32_t s, t;
+                uint8_t method;
+                if (!take(req.payload, pos, s) || !take(req.payload, pos, t) || !take(req.payload, pos, method)) {
+                    fail(req, "P2P request needs s, t and a method");
+                } else if (s < 0 || s >= g.n || t < 0 || t >= g.n) {
+                    fail(req, "vertex out of range");
+                } else if (!engine) {
+                    fail(req, "P2P queries need non-negative weights");
+                } else if (method == P2P_ALT && !engine->hasLandmarks()) {
+                    fail(req, "server has no landmarks, ALT is unavailable");
+                } else if (method > P2P_ALT) {
+                    fail(req, "unknown P2P method " + to_string(method));
+                } else {
+                    QueryResult r = method == P2P_DIJKSTRA ? engine->dijkstra(s, t)
+                                  : method == P2P_BIDIRECTIONAL ? engine->bidirectional(s, t)
+                                  : engine->altAStar(s, t);
+                    std::vector<char> body;
+                    append(body, r.distance);
+                    append(body, (int64_t)r.settled);
+                    respond(req, STATUS_OK, body);
+                }
+            } else {
+                fail(req, "unknown op " + to_string(req.op));
+            }
+        }
+
+        // a lone source runs in the worker's workspace, several go through
+        // one solveBatch call
+        if (!sources.empty()) {
+            try {
+                if (sources.size() == 1) {
+                    ResultView r = solver->solveInto(g, sources[0], ws);
+                    respond(*ssspReqs[0], STATUS_OK, distanceBody(r.distances.data, r.distances.n));
+                } else {
+                    std::vector<Result> results = solver->solveBatch(g, sources);
+                    for (size_t i = 0; i < ssspReqs.size(); i++) {
+                        const auto& dist = results[i].distances;
+                        respond(*ssspReqs[i], STATUS_OK, distanceBody(dist.data(), (int)dist.size()));
+                    }
+                }
+            } catch (const exception& e) {
+                for (const Request* req : ssspReqs) fail(*req, e.what());
+            }
+        }
+
+        ssspReqs.clear();
+        sources.clear();
+        batch.clear();
+    }
+}
+
+void QueryServer::run(const function<void()>& accept) {
+    {
+        std::lock_guard<std::mutex> lock(queueMu);
+        stopping = false;
+        shutdownRequested = false;
+    }
+    std::vector<std::thread> workers;
+    for (int i = 0; i < config.workers; i++) workers.emplace_back(&QueryServer::workerLoop, this);
+
+    accept();
+
+    {
+        std::lock_guard<std::mutex> lock(queueMu);
+        stopping = true;
+    }
+    queueCv.notify_all();
+    for (auto& w : workers) w.join();
+
+    if (shutdownRequested) {
+        respond(shutdownRequest, STATUS_OK, {});
+        shutdownRequest = Request();
+    }
+}
+
+void QueryServer::serveStdio() {
+    run([&] { readLoop(std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, false)); });
+}
+
+void QueryServer::serveSocket(const string& path) {
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw runtime_error("[ERR] Socket path too long: " + path);
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw runtime_error("[ERR] Cannot create socket");
+    unlink(path.c_str());
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        throw runtime_error("[ERR] Cannot listen on: " + path);
+    }
+    {
+        std::lock_guard<std::mutex> lock(connMu);
+        listenFd = fd;
+    }
+
+    run([&] {
+        while (true) {
+            int client = accept(fd, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                break;  // listen socket shut down by OP_SHUTDOWN
+            }
+
+            auto conn = std::make_shared<Connection>(client, client, true);
+            std::lock_guard<std::mutex> lock(connMu);
+            connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                             [](const weak_ptr<Connection>& c) { return c.expired(); }),
+                              connections.end());
+            connections.push_back(conn);
+            activeReaders++;
+            std::thread([this, conn] {
+                readLoop(conn);
+                std::lock_guard<std::mutex> lock(connMu);
+                activeReaders--;
+                readersCv.notify_all();
+            }).detach();
+        }
+
+        // stop reading from everyone still connected, queued work still gets answered
+        std::unique_lock<std::mutex> lock(connMu);
+        for (auto& c : connections) {
+            if (auto conn = c.lock()) ::shutdown(conn->inFd, SHUT_RD);
+        }
+        readersCv.wait(lock, [&] { return activeReaders == 0; });
+        connections.clear();
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(connMu);
+        listenFd = -1;
+    }
+    close(fd);
+    unlink(path.c_str());
+}
@@ -0,0 +1,53 @@
+#include "../inc/algos.h"
+#include "../inc/profile.h"
+#include "../inc/compressed.h"
+#include "../inc/negcycle.h"
+#include <stdexcept>
+
+template <class Solver>
+static SolverEntry serial(const string& key) {
+    return {key, false, [](int) { return unique_ptr<SSSPSolver>(new Solver()); }};
+}
+
+template <class Solver>
+static SolverEntry parallel(const string& key) {
+    return {key, true, [](int threads) { return unique_ptr<SSSPSolver>(new Solver(threads)); }};
+}
+
+static SolverEntry compressed(const string& key, CompressedSolver::Kind kind) {
+    return {key, false, [kind](int) { return unique_ptr<SSSPSolver>(new CompressedSolver(kind)); }};
+}
+
+const vector<SolverEntry>& solverRegistry() {
+    static const vector<SolverEntry> registry = {
+        serial<DijkstraSerial>("dijkstra"),
+        serial<DijkstraQuaternaryHeap>("dijkstra-4ary"),
+        serial<DijkstraPairingHeap>("dijkstra-pairing"),
+        serial<DijkstraRadixHeap>("dijkstra-radix"),
+        serial<BellmanFordSerial>("bellman-ford"),
+        serial<BFSSerial>("bfs"),
+        serial<SPFASerial>("spfa"),
+        serial<LevitSerial>("levit"),
+        compressed("dijkstra-vbyte", CompressedSolver::Kind::Dijkstra),
+        compressed("bfs-vbyte", CompressedSolver::Kind::BFS),
+        compressed("bellman-ford-vbyte", CompressedSolver::Kind::BellmanFord),
+        parallel<DijkstraParallel>("dijkstra-omp"),
+        parallel<BellmanFordParallel>("bellman-ford-omp"),
+        parallel<BFSParallel>("bfs-omp"),
+        parallel<SPFAParallel>("spfa-omp"),
+        parallel<LevitParallel>("levit-omp"),
+        parallel<DeltaSteppingParallel>("delta-stepping"),
+        parallel<NegativeCycleSolver>("bellman-ford-tarjan"),
+        parallel<AutoSolver>("auto"),
+    };
+    return registry;
+}
+
+const SolverEntry& findSolver(const string& key) {
+    for (const auto& entry : solverRegistry()) {
+        if (entry.key == key) return entry;
+    }
+    string known;
+    for (const auto& entry : solverRegistry()) known += (known.empty() ? "" : ", ") + entry.key;
+    throw runtime_error("[ERR] Unknown solver: " + key + " (" + known + ")");
+}
@@ -0,0 +1,178 @@
+#include "../inc/typed.h"
+#include "../inc/heaps.h"
+#include <chrono>
+#include <sstream>
+
+template <typename W, typename D, WeightClass C>
+class TypedEngineImpl : public TypedEngine {
+private:
+    static constexpr D INF_D = DistTraits<D>::INF;
+
+    BasicGraph<W> g;
+    std::vector<D> dist;
+    DAryHeap<4, D> heap;        // NonNegative
+    std::vector<int> queue;     // UnitWeights, General
+    std::vector<char> inQueue;  // General
+    std::vector<int> enqueued;  // General, a vertex queued n times means a negative cycle
+
+    void bfs(int source) {
+        int head = 0;
+        queue.clear();
+        queue.push_back(source);
+        dist[source] = 0;
+        const ll* off = g.offsets();
+        const int* to = g.targets();
+        while (head < (int)queue.size()) {
+            int u = queue[head++];
+            D next = dist[u] + 1;
+            for (ll e = off[u]; e < off[u + 1]; e++) {
+                int v = to[e];
+                if (dist[v] == INF_D) {
+                    dist[v] = next;
+                    queue.push_back(v);
+                }
+            }
+        }
+    }
+
+    void dijkstra(int source) {
+        const ll* off = g.offsets();
+        const int* to = g.targets();
+        const W* w = g.edgeWeights();
+        heap.clear();
+        dist[source] = 0;
+        heap.push(source, 0);
+        while (!heap.empty()) {
+            auto [du, u] = heap.pop();
+            // indexed heap: no stale entries, and every popped vertex is reached
+            for (ll e = off[u]; e < off[u + 1]; e++) {
+                int v = to[e];
+                D nd = du + (D)w[e];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    heap.push(v, nd);
+                }
+            }
+        }
+    }
+
+    void spfa(int source) {
+        const ll* off = g.offsets();
+        const int* to = g.targets();
+        const W* w = g.edgeWeights();
+        // circular FIFO, at most n vertices are queued at once
+        int head = 0, size = 1;
+        queue.assign(g.n, 0);
+        std::fill(inQueue.begin(), inQueue.end(), 0);
+        std::fill(enqueued.begin(), enqueued.end(), 0);
+        queue[0] = source;
+        inQueue[source] = 1;
+        enqueued[source] = 1;
+        dist[source] = 0;
+        while (size > 0) {
+            int u = queue[head];
+            head = head + 1 == g.n ? 0 : head + 1;
+            size--;
+            inQueue[u] = 0;
+            D du = dist[u];
+            for (ll e = off[u]; e < off[u + 1]; e++) {
+                int v = to[e];
+                D nd = du + (D)w[e];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    if (!inQueue[v]) {
+                        if (++enqueued[v] > g.n) {
+                            throw std::runtime_error("[ERR] Negative cycle reachable from " + std::to_string(source));
+                        }
+                        int tail = head + size;
+                        queue[tail >= g.n ? tail - g.n : tail] = v;
+                        size++;
+                        inQueue[v] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    explicit TypedEngineImpl(BasicGraph<W> graph) : g(std::move(graph)) {
+        if constexpr (C == WeightClass::NonNegative) heap.reset(g.n);
+        if constexpr (C == WeightClass::General) {
+            inQueue.assign(g.n, 0);
+            enqueued.assign(g.n, 0);
+        }
+        dist.assign(g.n, INF_D);
+    }
+
+    double solve(int source) override {
+        if (source < 0 || source >= g.n) {
+            throw std::runtime_error("[ERR] Source " + std::to_string(source) + " out of range");
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        std::fill(dist.begin(), dist.end(), INF_D);
+        if constexpr (C == WeightClass::UnitWeights) bfs(source);
+        else if constexpr (C == WeightClass::NonNegative) dijkstra(source);
+        else spfa(source);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    int vertices() const override { return g.n; }
+    ll edges() const override { return g.m; }
+    bool reached(int v) const override { return dist[v] != INF_D; }
+
+    std::string distance(int v) const override {
+        if (dist[v] == INF_D) return "INF";
+        std::ostringstream out;
+        out.precision(std::is_same<D, float>::value ? 9 : 17);
+        out << dist[v];
+        return out.str();
+    }
+
+    uint64_t distanceHash() const override { return fnv1a(dist.data(), dist.size() * sizeof(D)); }
+
+    std::string describe() const override {
+        const char* algo = C == WeightClass::UnitWeights ? "BFS"
+                         : C == WeightClass::NonNegative ? "Dijkstra (4-ary heap)"
+                                                         : "SPFA (negative cycle check)";
+        return std::string(WeightTraits<W>::name()) + " weights, " +
+               (std::is_floating_point<D>::value ? (sizeof(D) == 4 ? "float" : "double")
+                                                 : (sizeof(D) == 4 ? "int32" : "int64")) +
+               " distances, " + weightClassName(C) + ": " + algo;
+    }
+};
+
+// the one runtime switch: weight class of this graph -> instantiation
+template <typename W, typename D>
+static std::unique_ptr<TypedEngine> makeEngine(BasicGraph<W> g) {
+    switch (classifyWeights(g.edgeWeights(), g.m)) {
+    case WeightClass::UnitWeights:
+        return std::make_unique<TypedEngineImpl<W, D, WeightClass::UnitWeights>>(std::move(g));
+    case WeightClass::NonNegative:
+        return std::make_unique<TypedEngineImpl<W, D, WeightClass::NonNegative>>(std::move(g));
+    case WeightClass::General:
+        break;
+    }
+    return std::make_unique<TypedEngineImpl<W, D, WeightClass::General>>(std::move(g));
+}
+
+template <typename W>
+static std::unique_ptr<TypedEngine> loadAs(const std::string& filename, bool narrow, bool binary) {
+    BasicGraph<W> g = binary ? loadGraphBinary<W>(filename) : loadGraphText<W>(filename);
+    if (narrow) return makeEngine<W, typename WeightTraits<W>::Narrow>(std::move(g));
+    return makeEngine<W, typename WeightTraits<W>::Dist>(std::move(g));
+}
+
+std::unique_ptr<TypedEngine> loadTypedEngine(const std::string& filename, bool narrow, uint32_t textWeights) {
+    uint32_t type = graphFileWeightType(filename);
+    bool binary = type != 0;
+    if (!binary) type = textWeights;
+
+    switch (type) {
+    case WEIGHT_INT32: return loadAs<int32_t>(filename, narrow, binary);
+    case WEIGHT_INT64: return loadAs<int64_t>(filename, narrow, binary);
+    case WEIGHT_FLOAT32: return loadAs<float>(filename, narrow, binary);
+    case WEIGHT_UINT16: return loadAs<uint16_t>(filename, narrow, binary);
+    }
+    throw std::runtime_error("[ERR] No typed engine for " + weightTypeName(type) + " weights: " + filename);
+}
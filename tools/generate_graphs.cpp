@@ -1,92 +1,440 @@
+#include "../inc/graph_io.h"
 #include <iostream>
 #include <fstream>
-#include <set>
-#include <cstdlib>
-#include <ctime>
-#include <random>
-#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 using namespace std;
 
-int main(int argc, char* argv[]) {
-    if (argc != 6) {
-        cout << "Usage: ./gen_graph <vertices> <edges> <min_weight> <max_weight> <output_file>\n";
-        return 1;
+// Parallel, deterministic graph generator. Every edge is a pure function of
+// (seed, family, edge slot), so the same arguments give the same file on
+// any number of threads. Edges are packed as u << 32 | v, radix sorted (which
+// also makes them CSR order), deduplicated with self loops dropped, and
+// streamed out as binary CSR or as a text edge list.
+
+enum class Family { Uniform, RMAT, Grid2D, Grid3D, Road, BA };
+
+struct GenOptions {
+    ll n, m;
+    Weight min_w, max_w;
+    string out;
+    Family family = Family::Uniform;
+    uint64_t seed = 1;
+    int undirected = -1;          // -1 = the family's default
+    string format;                // "text" or "bin", empty = from the extension
+    double a = 0.57, b = 0.19, c = 0.19;  // R-MAT quadrants, d = 1 - a - b - c
+};
+
+// chance a road-like grid loses a street
+static const double ROAD_DROP = 0.2;
+// edges per write() when streaming
+static const ll CHUNK = 1 << 22;
+
+static void usage() {
+    cout << "Usage: ./gen_graph <vertices> <edges> <min_weight> <max_weight> <output_file> [options]\n"
+         << "  --family F        uniform (default), rmat, grid2d, grid3d, road, ba\n"
+         << "  --seed S          same seed and arguments give the same graph on any thread count (default 1)\n"
+         << "  --undirected      add every edge in both directions (default for grid2d, grid3d, road, ba)\n"
+         << "  --directed        don't\n"
+         << "  --format F        bin or text (default: bin if the output ends in .bin)\n"
+         << "  --rmat a,b,c      R-MAT quadrant probabilities (default 0.57,0.19,0.19)\n"
+         << "Families:\n"
+         << "  uniform  <edges> random pairs, stored as u < v unless undirected\n"
+         << "  rmat     vertices rounded up to a power of two, <edges> R-MAT samples, ids scrambled\n"
+         << "  grid2d   vertices rounded to a square, 4-neighbour lattice, <edges> ignored\n"
+         << "  grid3d   vertices rounded to a cube, 6-neighbour lattice, <edges> ignored\n"
+         << "  road     grid2d with " << (int)(ROAD_DROP * 100) << "% of streets removed and weights from\n"
+         << "           jittered street lengths\n"
+         << "  ba       Barabasi-Albert, <edges> / <vertices> attachments per vertex\n"
+         << "Duplicate edges and self loops are dropped, so a sampled family can come out a bit under <edges>.\n";
+}
+
+static Family parseFamily(const string& name) {
+    if (name == "uniform") return Family::Uniform;
+    if (name == "rmat") return Family::RMAT;
+    if (name == "grid2d") return Family::Grid2D;
+    if (name == "grid3d") return Family::Grid3D;
+    if (name == "road") return Family::Road;
+    if (name == "ba") return Family::BA;
+    throw runtime_error("[ERR] Unknown family: " + name + " (uniform, rmat, grid2d, grid3d, road, ba)");
+}
+
+// counter-based randomness (splitmix64): draw k of stream (tag, index) only
+// depends on the seed, never on which thread asks
+static inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+struct Stream {
+    uint64_t state;
+
+    Stream(uint64_t seed, uint64_t tag, uint64_t index) : state(mix64(mix64(seed ^ (tag << 56)) ^ index)) {}
+    uint64_t next() { return mix64(state += 0x9E3779B97F4A7C15ULL); }
+    double unit() { return (next() >> 11) * 0x1.0p-53; }
+};
+
+static inline uint64_t edgeKey(ll u, ll v) { return (uint64_t)u << 32 | (uint64_t)v; }
+
+// bijection on [0, 2^scale), spreads R-MAT's heavy low ids over the range
+static inline uint64_t scramble(uint64_t x, int scale, uint64_t seed) {
+    uint64_t mask = scale == 64 ? ~0ULL : (1ULL << scale) - 1;
+    int half = max(1, scale / 2);
+    x = (x * 0x9E3779B97F4A7C15ULL + seed) & mask;
+    x ^= x >> half;
+    x = (x * 0xBF58476D1CE4E5B9ULL + (seed >> 7)) & mask;
+    x ^= x >> half;
+    return x;
+}
+
+// Barabasi-Albert without a sequential pass (Sanders & Schulz): edge j
+// leaves vertex j / k, its target copies a uniformly random endpoint of the
+// edges before it. An even position is that edge's source, an odd one its
+// target, which is resolved the same way further back
+static ll baTarget(ll j, ll k, uint64_t seed) {
+    while (true) {
+        uint64_t r = Stream(seed, 6, j).next() % (uint64_t)(2 * j + 1);
+        if (r % 2 == 0) return (ll)(r / 2) / k;  // r == 2j picks j's own source, a self loop
+        j = (ll)(r - 1) / 2;
     }
+}
 
-    long long n = atoll(argv[1]); // vertices
-    long long m = atoll(argv[2]); // edges
-    int min_w = atoi(argv[3]);
-    int max_w = atoi(argv[4]);
-    string filename = argv[5];
+struct Layout {
+    ll n;       // vertices after rounding
+    ll slots;   // generated edges before dedup, one direction
+    int scale;  // R-MAT
+    ll side;    // grids
+    ll k;       // BA
+};
 
-    if (n <= 0 || m < 0 || min_w > max_w) {
-        cerr << "[ERR] Invalid input parameters.\n";
-        cerr << "  n must be > 0\n";
-        cerr << "  m must be >= 0\n";
-        cerr << "  min_weight must be <= max_weight\n";
-        return 1;
+static Layout layoutFor(const GenOptions& o) {
+    Layout l = {o.n, o.m, 0, 0, 0};
+    switch (o.family) {
+    case Family::Uniform:
+        break;
+    case Family::RMAT:
+        while ((1LL << l.scale) < o.n) l.scale++;
+        l.n = 1LL << l.scale;
+        break;
+    case Family::Grid2D:
+    case Family::Road:
+        l.side = max<ll>(1, llround(sqrt((double)o.n)));
+        l.n = l.side * l.side;
+        l.slots = l.n * 2;
+        break;
+    case Family::Grid3D:
+        l.side = max<ll>(1, llround(cbrt((double)o.n)));
+        l.n = l.side * l.side * l.side;
+        l.slots = l.n * 3;
+        break;
+    case Family::BA:
+        l.k = max<ll>(1, o.m / o.n);
+        l.slots = o.n * l.k;
+        break;
     }
+    return l;
+}
 
-    long long max_edges = (long long)n * (n - 1) / 2;
-    if (m > max_edges) {
-        cerr << "[ERR] Too many edges for the number of vertices.\n";
-        cerr << "  Max edges for " << n << " vertices: " << max_edges << "\n";
-        cerr << "  Requested: " << m << "\n";
-        return 1;
+// edge in slot i, a self loop when the slot has no edge (grid border, dropped street)
+static uint64_t generateEdge(const GenOptions& o, const Layout& l, ll i) {
+    switch (o.family) {
+    case Family::Uniform: {
+        Stream s(o.seed, 1, i);
+        ll u = (ll)(s.next() % (uint64_t)l.n), v = (ll)(s.next() % (uint64_t)l.n);
+        if (o.undirected == 0 && u > v) swap(u, v);  // as the old generator did
+        return edgeKey(u, v);
+    }
+    case Family::RMAT: {
+        Stream s(o.seed, 2, i);
+        uint64_t u = 0, v = 0;
+        for (int level = 0; level < l.scale; level++) {
+            double r = s.unit();
+            int right = r >= o.a && (r < o.a + o.b || r >= o.a + o.b + o.c);
+            int down = r >= o.a + o.b;
+            u = u << 1 | down;
+            v = v << 1 | right;
+        }
+        return edgeKey(scramble(u, l.scale, o.seed), scramble(v, l.scale, o.seed));
+    }
+    case Family::Grid2D:
+    case Family::Road: {
+        ll cell = i / 2, x = cell % l.side, y = cell / l.side;
+        bool across = i % 2 == 0;
+        if (across ? x + 1 == l.side : y + 1 == l.side) return edgeKey(cell, cell);
+        if (o.family == Family::Road && Stream(o.seed, 3, i).unit() < ROAD_DROP) return edgeKey(cell, cell);
+        return edgeKey(cell, across ? cell + 1 : cell + l.side);
+    }
+    case Family::Grid3D: {
+        ll cell = i / 3, dir = i % 3, side = l.side;
+        ll coord[3] = {cell % side, cell / side % side, cell / (side * side)};
+        ll step[3] = {1, side, side * side};
+        if (coord[dir] + 1 == side) return edgeKey(cell, cell);
+        return edgeKey(cell, cell + step[dir]);
+    }
+    case Family::BA:
+        return edgeKey(i / l.k, baTarget(i, l.k, o.seed));
+    }
+    return 0;
+}
+
+// road vertices sit on the lattice point plus up to 0.3 of jitter each way
+static void roadPoint(const GenOptions& o, const Layout& l, ll v, double& x, double& y) {
+    Stream s(o.seed, 4, v);
+    x = v % l.side + s.unit() * 0.6 - 0.3;
+    y = v / l.side + s.unit() * 0.6 - 0.3;
+}
+
+// symmetric in (u, v) so both directions of an undirected edge agree
+static Weight weightOf(const GenOptions& o, const Layout& l, ll u, ll v) {
+    if (u > v) swap(u, v);
+    ll range = (ll)o.max_w - o.min_w;
+    if (o.family == Family::Road) {
+        // streets are 0.4 .. 1.6 long (lattice step 1 plus jitter), mapped onto [min_w, max_w]
+        double ux, uy, vx, vy;
+        roadPoint(o, l, u, ux, uy);
+        roadPoint(o, l, v, vx, vy);
+        double t = min(1.0, max(0.0, (hypot(ux - vx, uy - vy) - 0.4) / 1.2));
+        return (Weight)(o.min_w + llround(t * range));
     }
+    return (Weight)(o.min_w + (ll)(Stream(o.seed, 5, edgeKey(u, v)).next() % (uint64_t)(range + 1)));
+}
+
+// sorted keys -> unique, self loops out. Blocks count survivors, a prefix
+// sum gives each block its output offset
+static vector<uint64_t> dedup(const vector<uint64_t>& keys) {
+    size_t len = keys.size();
+    int nthreads = omp_get_max_threads();
+    vector<size_t> kept(nthreads + 1, 0);
+    vector<uint64_t> out;
+
+    auto keep = [&](size_t i) {
+        uint64_t k = keys[i];
+        return (k >> 32) != (k & 0xffffffffULL) && (i == 0 || keys[i - 1] != k);
+    };
 
-    mt19937_64 rng(std::random_device{}());
-    uniform_int_distribution<long long> vertex_dist(0, n - 1);
-    uniform_int_distribution<int> weight_dist(min_w, max_w);
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int tid = omp_get_thread_num();
+        int team = omp_get_num_threads();
+        size_t lo = len * tid / team, hi = len * (tid + 1) / team;
 
-    set<pair<int, int>> edges;
-    
-    cerr << "[INFO] Generating graph with " << n << " vertices and " << m << " edges\n";
-    cerr << "[INFO] Weight range: [" << min_w << ", " << max_w << "]\n";
+        size_t count = 0;
+        for (size_t i = lo; i < hi; i++) count += keep(i);
+        kept[tid + 1] = count;
 
-    long long attempts = 0;
-    long long max_attempts = m * 10;  // Safety limit
-    
-    while ((long long)edges.size() < m && attempts < max_attempts) {
-        int u = vertex_dist(rng);
-        int v = vertex_dist(rng);
-        attempts++;
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int t = 0; t < team; t++) kept[t + 1] += kept[t];
+            out.resize(kept[team]);
+        }
 
-        if (u == v) continue;  // no self-loops
-        if (u > v) swap(u, v);  // normalize to avoid duplicates
-        
-        if (edges.count({u, v})) continue;  // no duplicate edges
-        
-        edges.insert({u, v});
+        size_t at = kept[tid];
+        for (size_t i = lo; i < hi; i++) {
+            if (keep(i)) out[at++] = keys[i];
+        }
     }
+    return out;
+}
 
-    if ((long long)edges.size() < m) {
-        cerr << "[WARN] Could only generate " << edges.size() << " edges out of " 
-             << m << " requested\n";
-        m = edges.size();
+// row offsets from sorted keys: row u starts at the first key with source >= u
+static vector<ll> rowOffsets(const vector<uint64_t>& keys, ll n) {
+    ll m = (ll)keys.size();
+    vector<ll> rowPtr(n + 1, m);
+
+    #pragma omp parallel for schedule(static)
+    for (ll i = 0; i < m; i++) {
+        ll u = (ll)(keys[i] >> 32);
+        ll prev = i == 0 ? -1 : (ll)(keys[i - 1] >> 32);
+        for (ll r = prev + 1; r <= u; r++) rowPtr[r] = i;
     }
+    return rowPtr;
+}
+
+// header, rowPtr, then colIdx and weights a chunk at a time; the header
+// goes in last once the checksum is known
+static void writeBinary(const GenOptions& o, const Layout& l, const vector<uint64_t>& keys,
+                        const vector<ll>& rowPtr) {
+    ofstream file(o.out, ios::binary | ios::trunc);
+    if (!file.is_open()) throw runtime_error("[ERR] Cannot open file: " + o.out);
+
+    ll m = (ll)keys.size();
+    BinaryGraphHeader h = makeGraphHeader(l.n, m);
+    const char zeros[8] = {0};
+    file.write((const char*)&h, sizeof(h));  // placeholder
 
-    // Open output file
-    ofstream outfile(filename);
-    if (!outfile.is_open()) {
-        cerr << "[ERR] Failed to open file: " << filename << "\n";
+    uint64_t sum = fnv1a(rowPtr.data(), rowPtr.size() * sizeof(ll));
+    file.write((const char*)rowPtr.data(), rowPtr.size() * sizeof(ll));
+
+    vector<int> cols;
+    for (ll lo = 0; lo < m; lo += CHUNK) {
+        ll hi = min(m, lo + CHUNK);
+        cols.resize(hi - lo);
+        #pragma omp parallel for schedule(static)
+        for (ll i = lo; i < hi; i++) cols[i - lo] = (int)(keys[i] & 0xffffffffULL);
+        sum = fnv1a(cols.data(), cols.size() * sizeof(int), sum);
+        file.write((const char*)cols.data(), cols.size() * sizeof(int));
+    }
+    size_t colPad = h.weightsOffset - h.colIdxOffset - m * sizeof(int);
+    sum = fnv1a(zeros, colPad, sum);
+    file.write(zeros, colPad);
+
+    vector<Weight> ws;
+    for (ll lo = 0; lo < m; lo += CHUNK) {
+        ll hi = min(m, lo + CHUNK);
+        ws.resize(hi - lo);
+        #pragma omp parallel for schedule(static)
+        for (ll i = lo; i < hi; i++) ws[i - lo] = weightOf(o, l, (ll)(keys[i] >> 32), (ll)(keys[i] & 0xffffffffULL));
+        sum = fnv1a(ws.data(), ws.size() * sizeof(Weight), sum);
+        file.write((const char*)ws.data(), ws.size() * sizeof(Weight));
+    }
+    size_t wBytes = m * sizeof(Weight);
+    size_t wPad = alignTo8(wBytes) - wBytes;
+    sum = fnv1a(zeros, wPad, sum);
+    file.write(zeros, wPad);
+
+    h.checksum = sum;
+    file.seekp(0);
+    file.write((const char*)&h, sizeof(h));
+    if (!file) throw runtime_error("[ERR] Failed writing: " + o.out);
+}
+
+// "n m" header then "u v w" lines, each thread formats its slice of a chunk
+static void writeText(const GenOptions& o, const Layout& l, const vector<uint64_t>& keys) {
+    ofstream file(o.out, ios::trunc);
+    if (!file.is_open()) throw runtime_error("[ERR] Cannot open file: " + o.out);
+
+    ll m = (ll)keys.size();
+    file << l.n << " " << m << "\n";
+
+    int nthreads = omp_get_max_threads();
+    vector<string> text(nthreads);
+    for (ll lo = 0; lo < m; lo += CHUNK) {
+        ll hi = min(m, lo + CHUNK);
+        #pragma omp parallel num_threads(nthreads)
+        {
+            int tid = omp_get_thread_num();
+            int team = omp_get_num_threads();
+            ll a = lo + (hi - lo) * tid / team, b = lo + (hi - lo) * (tid + 1) / team;
+            string& s = text[tid];
+            s.clear();
+            auto put = [&s](ll x, char sep) {
+                char buf[24];
+                s.append(buf, to_chars(buf, buf + sizeof(buf), x).ptr - buf);
+                s.push_back(sep);
+            };
+            for (ll i = a; i < b; i++) {
+                ll u = (ll)(keys[i] >> 32), v = (ll)(keys[i] & 0xffffffffULL);
+                put(u, ' ');
+                put(v, ' ');
+                put(weightOf(o, l, u, v), '\n');
+            }
+        }
+        for (const auto& s : text) file.write(s.data(), s.size());
+    }
+    if (!file) throw runtime_error("[ERR] Failed writing: " + o.out);
+}
+
+static GenOptions parseArgs(int argc, char* argv[]) {
+    GenOptions o;
+    o.n = atoll(argv[1]);
+    o.m = atoll(argv[2]);
+    o.min_w = atoi(argv[3]);
+    o.max_w = atoi(argv[4]);
+    o.out = argv[5];
+
+    for (int i = 6; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--undirected") {
+            o.undirected = 1;
+            continue;
+        }
+        if (flag == "--directed") {
+            o.undirected = 0;
+            continue;
+        }
+        if (i + 1 >= argc) throw runtime_error("[ERR] Missing value for " + flag);
+        string value = argv[++i];
+        if (flag == "--family") o.family = parseFamily(value);
+        else if (flag == "--seed") o.seed = stoull(value);
+        else if (flag == "--format") o.format = value;
+        else if (flag == "--rmat") {
+            if (sscanf(value.c_str(), "%lf,%lf,%lf", &o.a, &o.b, &o.c) != 3) {
+                throw runtime_error("[ERR] --rmat wants a,b,c");
+            }
+        } else throw runtime_error("[ERR] Unknown option: " + flag);
+    }
+
+    if (o.undirected < 0) {
+        o.undirected = o.family == Family::Uniform || o.family == Family::RMAT ? 0 : 1;
+    }
+    if (o.format.empty()) {
+        bool bin = o.out.size() >= 4 && o.out.compare(o.out.size() - 4, 4, ".bin") == 0;
+        o.format = bin ? "bin" : "text";
+    }
+    if (o.format != "bin" && o.format != "text") throw runtime_error("[ERR] Unknown format: " + o.format);
+    if (o.n <= 0 || o.m < 0 || o.min_w > o.max_w) {
+        throw runtime_error("[ERR] Invalid input parameters.\n"
+                            "  n must be > 0\n  m must be >= 0\n  min_weight must be <= max_weight");
+    }
+    if (o.a < 0 || o.b < 0 || o.c < 0 || o.a + o.b + o.c > 1) {
+        throw runtime_error("[ERR] R-MAT probabilities must be >= 0 and sum to at most 1");
+    }
+    if (o.family == Family::Uniform && o.undirected == 0 && o.m > o.n * (o.n - 1) / 2) {
+        throw runtime_error("[ERR] Too many edges for the number of vertices.\n  Max edges for " +
+                            to_string(o.n) + " vertices: " + to_string(o.n * (o.n - 1) / 2));
+    }
+    return o;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 6) {
+        usage();
         return 1;
     }
 
-    outfile << n << " " << m << "\n";
-    
-    // Write edges to file
-    for (auto e : edges) {
-        int w = weight_dist(rng);
-        outfile << e.first << " " << e.second << " " << w << "\n";
-    }
-    outfile.close();
-    
-    cerr << "[DONE] Graph generation complete.\n";
-    cerr << "  File: " << filename << "\n";
-    cerr << "  Vertices: " << n << "\n";
-    cerr << "  Edges: " << edges.size() << "\n";
-    cerr << "  Density: " << (double)edges.size() * 2 / (double)(n * (n - 1)) * 100 << "%\n";
-    
+    try {
+        GenOptions o = parseArgs(argc, argv);
+        Layout l = layoutFor(o);
+        if (l.n > numeric_limits<int>::max()) throw runtime_error("[ERR] Too many vertices");
+
+        auto start = chrono::high_resolution_clock::now();
+        const char* names[] = {"uniform", "rmat", "grid2d", "grid3d", "road", "ba"};
+        cerr << "[INFO] Generating " << names[(int)o.family] << " graph: " << l.n << " vertices, "
+             << l.slots << " edge slots" << (o.undirected ? " (undirected)" : "") << ", seed " << o.seed << "\n";
+        cerr << "[INFO] Weight range: [" << o.min_w << ", " << o.max_w << "]\n";
+
+        ll copies = o.undirected ? 2 : 1;
+        vector<uint64_t> keys(l.slots * copies);
+        #pragma omp parallel for schedule(static)
+        for (ll i = 0; i < l.slots; i++) {
+            uint64_t k = generateEdge(o, l, i);
+            keys[i] = k;
+            if (o.undirected) keys[l.slots + i] = (k << 32) | (k >> 32);
+        }
+
+        int bits = 1;
+        while ((1LL << bits) < l.n) bits++;
+        parallelRadixSort(keys, 32 + bits);  // no passes over the unused high bits of the source
+        keys = dedup(keys);
+        auto made = chrono::high_resolution_clock::now();
+        cerr << "[INFO] " << keys.size() << " edges after dropping duplicates and self loops, "
+             << chrono::duration<double, milli>(made - start).count() << " ms\n";
+
+        if (o.format == "bin") writeBinary(o, l, keys, rowOffsets(keys, l.n));
+        else writeText(o, l, keys);
+
+        auto end = chrono::high_resolution_clock::now();
+        cerr << "[DONE] Graph generation complete.\n";
+        cerr << "  File: " << o.out << " (" << o.format << ")\n";
+        cerr << "  Vertices: " << l.n << "\n";
+        cerr << "  Edges: " << keys.size() << "\n";
+        cerr << "  Time: " << chrono::duration<double, milli>(end - start).count() << " ms\n";
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
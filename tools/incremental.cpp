@@ -0,0 +1,100 @@
+#include "../inc/graph_io.h"
+#include "../inc/algos.h"
+#include "../inc/incremental.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+using namespace std;
+
+// random batches of weight changes, inserts and deletes: incremental repair
+// vs a full solve on a snapshot of the updated graph, checked against it
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: ./incremental <graph_file> [num_batches] [batch_size] [source] [seed]\n";
+        return 1;
+    }
+
+    string graph_file = argv[1];
+    int batches = argc > 2 ? atoi(argv[2]) : 20;
+    int batchSize = argc > 3 ? atoi(argv[3]) : 100;
+    int source = argc > 4 ? atoi(argv[4]) : 0;
+    unsigned seed = argc > 5 ? (unsigned)atoi(argv[5]) : 1;
+
+    try {
+        Graph g = loadGraph(graph_file);
+        cout << "[INFO] Graph loaded: " << g.n << " vertices, " << g.m << " edges\n";
+        if (g.n == 0) return 0;
+
+        Weight lo = INF, hi = 1;
+        const Weight* w = g.edgeWeights();
+        for (ll e = 0; e < g.m; e++) {
+            lo = min(lo, w[e]);
+            hi = max(hi, w[e]);
+        }
+        if (lo == INF) lo = 1;
+
+        auto initStart = chrono::high_resolution_clock::now();
+        IncrementalSSSP inc(g, source);
+        auto initEnd = chrono::high_resolution_clock::now();
+        cout << "[INFO] Initial tree in " << chrono::duration<double, milli>(initEnd - initStart).count() << " ms\n";
+
+        mt19937 rng(seed);
+        uniform_int_distribution<int> pickVertex(0, g.n - 1);
+        uniform_int_distribution<Weight> pickWeight(lo, hi);
+        DijkstraRadixHeap full;
+
+        double incMs = 0, fullMs = 0;
+        ll invalidated = 0, settled = 0;
+        int mismatches = 0;
+
+        cout << "\n" << right << setw(6) << "Batch" << setw(13) << "Invalidated" << setw(10) << "Settled"
+             << setw(14) << "Repair (ms)" << setw(12) << "Full (ms)\n";
+        for (int b = 0; b < batches; b++) {
+            const DynamicGraph& dg = inc.graph();
+            vector<EdgeUpdate> batch;
+            for (int i = 0; i < batchSize; i++) {
+                int u = pickVertex(rng);
+                const auto& outs = dg.outEdges(u);
+                int kind = outs.empty() ? 2 : (int)(rng() % 4);
+                if (kind == 2) {
+                    batch.push_back({EdgeUpdate::INSERT, u, pickVertex(rng), pickWeight(rng)});
+                    continue;
+                }
+                Edge e = outs[rng() % outs.size()];
+                if (kind == 0) batch.push_back({EdgeUpdate::SET, u, e.to, e.weight + 1 + e.weight / 2});
+                else if (kind == 1) batch.push_back({EdgeUpdate::SET, u, e.to, e.weight / 2});
+                else batch.push_back({EdgeUpdate::DELETE, u, e.to, 0});
+            }
+
+            UpdateStats s = inc.apply(batch);
+            Graph snapshot = inc.graph().toGraph();
+            Result r = full.solve(snapshot, source);
+            incMs += s.time_ms;
+            fullMs += r.time_ms;
+            invalidated += s.invalidated;
+            settled += s.settled;
+
+            for (int v = 0; v < g.n; v++) {
+                if (r.distances[v] != inc.distances()[v]) {
+                    if (mismatches++ < 10) {
+                        cout << "[ERR] batch " << b << ": dist[" << v << "] = " << inc.distances()[v]
+                             << ", expected " << r.distances[v] << "\n";
+                    }
+                }
+            }
+            cout << setw(6) << b << setw(13) << s.invalidated << setw(10) << s.settled << fixed
+                 << setprecision(4) << setw(14) << s.time_ms << setw(11) << r.time_ms << "\n";
+        }
+
+        cout << "\n[INFO] " << batches << " batches of " << batchSize << " updates: repair avg " << fixed
+             << setprecision(4) << incMs / max(batches, 1) << " ms (" << setprecision(1)
+             << (double)invalidated / max(batches, 1) << " invalidated, " << (double)settled / max(batches, 1)
+             << " settled), full solve avg " << setprecision(4) << fullMs / max(batches, 1) << " ms, "
+             << setprecision(2) << (incMs > 0 ? fullMs / incMs : 0) << "x\n";
+        cout << "[INFO] " << mismatches << " mismatches\n";
+        return mismatches == 0 ? 0 : 1;
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+}
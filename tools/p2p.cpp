@@ -0,0 +1,81 @@
+#include "../inc/graph_io.h"
+#include "../inc/algos.h"
+#include "../inc/p2p.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+using namespace std;
+
+// random s -> t queries: full SSSP vs early-exit Dijkstra vs bidirectional
+// vs ALT, all checked against each other
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: ./p2p <graph_file> [num_queries] [num_landmarks] [seed]\n";
+        cout << "  landmarks are loaded from / saved to <graph_file>.lmk\n";
+        return 1;
+    }
+
+    string graph_file = argv[1];
+    int queries = argc > 2 ? atoi(argv[2]) : 100;
+    int k = argc > 3 ? atoi(argv[3]) : 16;
+    unsigned seed = argc > 4 ? (unsigned)atoi(argv[4]) : 1;
+
+    try {
+        Graph g = loadGraph(graph_file);
+        cout << "[INFO] Graph loaded: " << g.n << " vertices, " << g.m << " edges\n";
+        if (g.n == 0) return 0;
+
+        Graph rev = g.transpose();
+        auto lm = make_shared<LandmarkTable>(loadOrBuildLandmarks(g, rev, graph_file, k));
+        cout << "[INFO] " << lm->k << " landmarks ready in " << lm->time_ms << " ms\n";
+
+        PointToPointEngine engine(g, rev, lm);
+        DijkstraRadixHeap full;
+
+        mt19937 rng(seed);
+        uniform_int_distribution<int> pick(0, g.n - 1);
+
+        const int METHODS = 4;
+        string names[METHODS] = {"Full SSSP (" + full.getName() + ")", "", "", ""};
+        double time_ms[METHODS] = {0};
+        ll settled[METHODS] = {0};
+        int mismatches = 0;
+
+        for (int q = 0; q < queries; q++) {
+            int s = pick(rng), t = pick(rng);
+
+            Result r = full.solve(g, s);
+            time_ms[0] += r.time_ms;
+            settled[0] += g.n;
+
+            QueryResult res[3] = {engine.dijkstra(s, t), engine.bidirectional(s, t), engine.altAStar(s, t)};
+            for (int i = 0; i < 3; i++) {
+                names[i + 1] = res[i].algorithm_name;
+                time_ms[i + 1] += res[i].time_ms;
+                settled[i + 1] += res[i].settled;
+                if (res[i].distance != r.distances[t]) {
+                    mismatches++;
+                    cout << "[ERR] " << res[i].algorithm_name << " " << s << " -> " << t << ": "
+                         << res[i].distance << ", expected " << r.distances[t] << "\n";
+                }
+            }
+        }
+
+        cout << "\n" << left << setw(32) << "Method" << right << setw(16) << "Avg time (ms)"
+             << setw(18) << "Avg settled" << setw(12) << "Speedup\n";
+        cout << string(78, '-') << "\n";
+        for (int i = 0; i < METHODS; i++) {
+            double avg = queries > 0 ? time_ms[i] / queries : 0;
+            double speedup = time_ms[i] > 0 ? time_ms[0] / time_ms[i] : 0;
+            cout << left << setw(32) << names[i] << right << fixed << setprecision(4) << setw(16) << avg
+                 << setw(18) << setprecision(1) << (queries > 0 ? (double)settled[i] / queries : 0)
+                 << setw(11) << setprecision(2) << speedup << "x\n";
+        }
+        cout << "\n[INFO] " << queries << " queries, " << mismatches << " mismatches\n";
+        return mismatches == 0 ? 0 : 1;
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,58 @@
+#include "../inc/graph_io.h"
+#include "../inc/algos.h"
+#include "../inc/server.h"
+#include <iostream>
+#include <csignal>
+using namespace std;
+
+// loads the graph once and answers queries until OP_SHUTDOWN, protocol in
+// inc/server.h. Logs go to stderr since stdout may be the protocol stream
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: ./sssp_server <graph_file> [socket_path|-] [workers] [solver] [landmarks] [max_batch]\n";
+        cerr << "  socket_path: Unix socket to listen on, - (default) serves stdin/stdout\n";
+        cerr << "  solver: registry key (default dijkstra-radix), see ./benchmark --help\n";
+        cerr << "  landmarks: ALT landmark count, 0 disables ALT (default 16)\n";
+        return 1;
+    }
+
+    string graph_file = argv[1];
+    string socket_path = argc > 2 ? argv[2] : "-";
+    ServerConfig config;
+    config.workers = argc > 3 ? atoi(argv[3]) : 8;
+    string solver = argc > 4 ? argv[4] : "dijkstra-radix";
+    int k = argc > 5 ? atoi(argv[5]) : 16;
+    config.maxBatch = argc > 6 ? atoi(argv[6]) : 16;
+
+    // a client hanging up mid-response must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    try {
+        // one solver per worker; parallel ones get a single thread since the
+        // workers already fill the cores
+        const SolverEntry& entry = findSolver(solver);
+        QueryServer::SolverFactory factory = [&entry] { return entry.make(1); };
+        Graph g = loadGraph(graph_file);
+        cerr << "[INFO] Graph loaded: " << g.n << " vertices, " << g.m << " edges\n";
+
+        shared_ptr<const LandmarkTable> landmarks;
+        const Weight* w = g.edgeWeights();
+        bool nonNegative = none_of(w, w + g.m, [](Weight x) { return x < 0; });
+        if (k > 0 && nonNegative && g.n > 0) {
+            landmarks = make_shared<LandmarkTable>(loadOrBuildLandmarks(g, g.transpose(), graph_file, k));
+            cerr << "[INFO] " << landmarks->k << " landmarks ready in " << landmarks->time_ms << " ms\n";
+        }
+
+        QueryServer server(g, factory, landmarks, config);
+        cerr << "[INFO] Serving on " << (socket_path == "-" ? "stdin/stdout" : socket_path) << " with "
+             << config.workers << " workers (" << solver << ")\n";
+        if (socket_path == "-") server.serveStdio();
+        else server.serveSocket(socket_path);
+
+        cerr << "[DONE] Latency:\n" << server.latencyReport();
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}